@@ -0,0 +1,142 @@
+/* Synthetic archive generator.
+ *
+ * Emits minimal but valid ZIP archives: stored entries with correct
+ * CRCs, a central directory, and an EOCD record with an optional
+ * comment. Payloads come from a fixed-seed xorshift generator, so the
+ * same options always produce byte-identical archives and benchmark
+ * runs are comparable across machines.
+ */
+#include "bench_zipgen.h"
+
+#include "ziprand_internal.h" /* ziprand_crc32 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void put_u16(FILE* f, uint16_t v)
+{
+    uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+    fwrite(b, 1, 2, f);
+}
+
+static void put_u32(FILE* f, uint32_t v)
+{
+    uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    fwrite(b, 1, 4, f);
+}
+
+static uint64_t rng_next(uint64_t* state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+void bench_zipgen_name(size_t i, char* buf, size_t buf_size)
+{
+    snprintf(buf, buf_size, "dir%zu/file%07zu.bin", i % 16, i);
+}
+
+int bench_zipgen_write(const char* path, const bench_zipgen_opts_t* opts)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return -1;
+
+    uint8_t* payload = malloc(opts->entry_size ? opts->entry_size : 1);
+    uint32_t* crcs = malloc(opts->entry_count * sizeof(uint32_t));
+    uint64_t* offsets = malloc(opts->entry_count * sizeof(uint64_t));
+    if (!payload || !crcs || !offsets)
+        goto fail;
+
+    uint64_t rng = 0x2545f4914f6cdd1dull;
+    for (size_t b = 0; b < opts->entry_size; b++)
+        payload[b] = (uint8_t)rng_next(&rng);
+
+    char name[40];
+    uint64_t pos = 0;
+
+    /* local headers + data */
+    for (size_t i = 0; i < opts->entry_count; i++) {
+        bench_zipgen_name(i, name, sizeof(name));
+        uint16_t name_len = (uint16_t)strlen(name);
+
+        /* vary the first bytes so per-entry CRCs differ */
+        if (opts->entry_size >= 8)
+            memcpy(payload, &i, 8);
+        crcs[i] = ziprand_crc32(0, payload, opts->entry_size);
+        offsets[i] = pos;
+
+        put_u32(f, 0x04034b50); /* local file header */
+        put_u16(f, 20);         /* version needed */
+        put_u16(f, 0);          /* flags */
+        put_u16(f, 0);          /* method: stored */
+        put_u16(f, 0);          /* mod time */
+        put_u16(f, 0);          /* mod date */
+        put_u32(f, crcs[i]);
+        put_u32(f, (uint32_t)opts->entry_size);
+        put_u32(f, (uint32_t)opts->entry_size);
+        put_u16(f, name_len);
+        put_u16(f, 0); /* extra len */
+        fwrite(name, 1, name_len, f);
+        fwrite(payload, 1, opts->entry_size, f);
+
+        pos += 30 + name_len + opts->entry_size;
+    }
+
+    /* central directory */
+    uint64_t cd_offset = pos;
+    for (size_t i = 0; i < opts->entry_count; i++) {
+        bench_zipgen_name(i, name, sizeof(name));
+        uint16_t name_len = (uint16_t)strlen(name);
+
+        put_u32(f, 0x02014b50); /* central directory header */
+        put_u16(f, 20);         /* version made by */
+        put_u16(f, 20);         /* version needed */
+        put_u16(f, 0);          /* flags */
+        put_u16(f, 0);          /* method: stored */
+        put_u16(f, 0);          /* mod time */
+        put_u16(f, 0);          /* mod date */
+        put_u32(f, crcs[i]);
+        put_u32(f, (uint32_t)opts->entry_size);
+        put_u32(f, (uint32_t)opts->entry_size);
+        put_u16(f, name_len);
+        put_u16(f, 0); /* extra len */
+        put_u16(f, 0); /* comment len */
+        put_u16(f, 0); /* disk number */
+        put_u16(f, 0); /* internal attrs */
+        put_u32(f, 0); /* external attrs */
+        put_u32(f, (uint32_t)offsets[i]);
+        fwrite(name, 1, name_len, f);
+
+        pos += 46 + name_len;
+    }
+
+    /* EOCD with optional comment */
+    put_u32(f, 0x06054b50);
+    put_u16(f, 0); /* this disk */
+    put_u16(f, 0); /* CD disk */
+    put_u16(f, (uint16_t)opts->entry_count);
+    put_u16(f, (uint16_t)opts->entry_count);
+    put_u32(f, (uint32_t)(pos - cd_offset));
+    put_u32(f, (uint32_t)cd_offset);
+    put_u16(f, (uint16_t)opts->comment_len);
+    for (size_t i = 0; i < opts->comment_len; i++)
+        fputc('x', f);
+
+    free(payload);
+    free(crcs);
+    free(offsets);
+    return fclose(f) == 0 ? 0 : -1;
+
+fail:
+    free(payload);
+    free(crcs);
+    free(offsets);
+    fclose(f);
+    return -1;
+}
@@ -0,0 +1,24 @@
+/* Synthetic archive generator for the benchmark suite. */
+#ifndef BENCH_ZIPGEN_H
+#define BENCH_ZIPGEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Shape of a generated archive. Entries are stored (method 0) with
+ * deterministic pseudo-random payloads, named "dirD/fileNNNNNNN.bin"
+ * so prefix and hash lookups both have realistic keys. */
+typedef struct {
+    size_t entry_count;
+    size_t entry_size;       /* uncompressed bytes per entry */
+    size_t comment_len;      /* archive comment length (EOCD scan stress) */
+} bench_zipgen_opts_t;
+
+/* Write a synthetic archive to path. Returns 0 on success, -1 on error. */
+int bench_zipgen_write(const char* path, const bench_zipgen_opts_t* opts);
+
+/* Format the name of generated entry i into buf (as written by
+ * bench_zipgen_write); buf must hold at least 40 bytes. */
+void bench_zipgen_name(size_t i, char* buf, size_t buf_size);
+
+#endif /* BENCH_ZIPGEN_H */
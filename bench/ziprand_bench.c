@@ -0,0 +1,312 @@
+/* Microbenchmark suite.
+ *
+ * Exercises the hot paths against synthetic archives and prints one JSON
+ * document to stdout, so CI can diff throughput numbers between
+ * revisions and gate releases on them:
+ *
+ *   - ziprand_open cost as the entry count grows
+ *   - ziprand_find_entry / ziprand_find_entries lookup throughput
+ *   - ziprand_fread_at at several read sizes and batch depths, for the
+ *     file and memory backends
+ *   - EOCD location with a maximal archive comment
+ *
+ * Archives are generated under TMPDIR (or /tmp) and removed on exit.
+ * Run through meson: `meson test --benchmark -C builddir`.
+ */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L /* clock_gettime */
+#endif
+
+#include "bench_zipgen.h"
+#include "ziprand.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static char bench_dir[256];
+static int emitted;
+
+static void emit(const char* name, const char* params, double value, const char* unit)
+{
+    printf("%s    {\"name\": \"%s\", \"params\": {%s}, \"value\": %.1f, \"unit\": \"%s\"}",
+           emitted ? ",\n" : "", name, params, value, unit);
+    emitted = 1;
+}
+
+static void bench_path(char* buf, size_t buf_size, const char* leaf)
+{
+    snprintf(buf, buf_size, "%s/%s", bench_dir, leaf);
+}
+
+/* --- ziprand_open vs entry count ------------------------------------- */
+
+static int bench_open(void)
+{
+    static const size_t counts[] = {1000, 10000, 60000};
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        char path[300];
+        bench_path(path, sizeof(path), "open.zip");
+
+        bench_zipgen_opts_t opts = {counts[c], 64, 0};
+        if (bench_zipgen_write(path, &opts) != 0)
+            return -1;
+
+        int reps = counts[c] >= 60000 ? 20 : 100;
+        uint64_t best = UINT64_MAX;
+        for (int r = 0; r < reps; r++) {
+            uint64_t t0 = now_ns();
+            ziprand_io_t* io = ziprand_io_file(path);
+            ziprand_archive_t* archive = io ? ziprand_open(io) : NULL;
+            if (!archive)
+                return -1;
+            uint64_t elapsed = now_ns() - t0;
+            ziprand_close(archive);
+            free(io);
+            if (elapsed < best)
+                best = elapsed;
+        }
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"entries\": %zu", counts[c]);
+        emit("open", params, (double)best / 1e6, "ms");
+        emit("open_throughput", params, (double)counts[c] * 1e9 / (double)best, "entries/s");
+        remove(path);
+    }
+    return 0;
+}
+
+/* --- name lookup throughput ------------------------------------------ */
+
+static int bench_lookup(void)
+{
+    enum { ENTRIES = 60000, QUERIES = 60000 };
+
+    char path[300];
+    bench_path(path, sizeof(path), "lookup.zip");
+    bench_zipgen_opts_t opts = {ENTRIES, 0, 0};
+    if (bench_zipgen_write(path, &opts) != 0)
+        return -1;
+
+    ziprand_io_t* io = ziprand_io_file(path);
+    ziprand_archive_t* archive = io ? ziprand_open(io) : NULL;
+    if (!archive)
+        return -1;
+
+    /* shuffled query order defeats any accidental locality */
+    char* names = malloc((size_t)QUERIES * 40);
+    const char** queries = malloc(QUERIES * sizeof(char*));
+    const ziprand_entry_t** out = malloc(QUERIES * sizeof(*out));
+    if (!names || !queries || !out)
+        return -1;
+    uint64_t rng = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < QUERIES; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        bench_zipgen_name(rng % ENTRIES, names + i * 40, 40);
+        queries[i] = names + i * 40;
+    }
+
+    uint64_t t0 = now_ns();
+    size_t found = 0;
+    for (size_t i = 0; i < QUERIES; i++)
+        found += ziprand_find_entry(archive, queries[i]) != NULL;
+    uint64_t serial_ns = now_ns() - t0;
+
+    t0 = now_ns();
+    if (ziprand_find_entries(archive, queries, QUERIES, out) != ZIPRAND_OK)
+        return -1;
+    uint64_t batch_ns = now_ns() - t0;
+
+    if (found != QUERIES)
+        return -1;
+
+    char params[64];
+    snprintf(params, sizeof(params), "\"entries\": %d", ENTRIES);
+    emit("find_entry", params, (double)QUERIES * 1e9 / (double)serial_ns, "lookups/s");
+    emit("find_entries_batch", params, (double)QUERIES * 1e9 / (double)batch_ns, "lookups/s");
+
+    free(names);
+    free(queries);
+    free(out);
+    ziprand_close(archive);
+    free(io);
+    remove(path);
+    return 0;
+}
+
+/* --- random reads: sizes, batch depths, backends ---------------------- */
+
+static int bench_read_backend(ziprand_archive_t* archive, const char* backend)
+{
+    static const size_t sizes[] = {4096, 65536, 1048576};
+    static const size_t depths[] = {1, 8, 32};
+
+    const ziprand_entry_t* entry = ziprand_get_entry_by_index(archive, 0);
+    if (!entry)
+        return -1;
+    uint64_t span = entry->uncompressed_size;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t size = sizes[s];
+
+        for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+            size_t depth = depths[d];
+            size_t total_reads = 4096 / depth * depth; /* same byte volume per depth */
+
+            ziprand_file_t* file = ziprand_fopen(archive, entry);
+            ziprand_read_req_t* reqs = malloc(depth * sizeof(*reqs));
+            uint8_t* buf = malloc(depth * size);
+            if (!file || !reqs || !buf)
+                return -1;
+
+            uint64_t rng = 0xda942042e4dd58b5ull;
+            uint64_t t0 = now_ns();
+            for (size_t i = 0; i < total_reads; i += depth) {
+                for (size_t q = 0; q < depth; q++) {
+                    rng ^= rng << 13;
+                    rng ^= rng >> 7;
+                    rng ^= rng << 17;
+                    reqs[q].offset = rng % (span - size);
+                    reqs[q].buffer = buf + q * size;
+                    reqs[q].size = size;
+                }
+                if (depth == 1) {
+                    if (ziprand_fread_at(file, reqs[0].offset, reqs[0].buffer, size) !=
+                        (int64_t)size)
+                        return -1;
+                } else if (ziprand_fread_batch(file, reqs, depth) !=
+                           (int64_t)(depth * size)) {
+                    return -1;
+                }
+            }
+            uint64_t elapsed = now_ns() - t0;
+
+            double mib = (double)total_reads * (double)size / (1024.0 * 1024.0);
+            char params[96];
+            snprintf(params, sizeof(params),
+                     "\"backend\": \"%s\", \"size\": %zu, \"depth\": %zu", backend, size,
+                     depth);
+            emit("fread_at", params, mib * 1e9 / (double)elapsed, "MiB/s");
+
+            free(buf);
+            free(reqs);
+            ziprand_fclose(file);
+        }
+    }
+    return 0;
+}
+
+static int bench_read(void)
+{
+    char path[300];
+    bench_path(path, sizeof(path), "read.zip");
+
+    /* one large stored entry keeps the read path free of decompression */
+    bench_zipgen_opts_t opts = {1, 32u << 20, 0};
+    if (bench_zipgen_write(path, &opts) != 0)
+        return -1;
+
+    ziprand_io_t* io = ziprand_io_file(path);
+    ziprand_archive_t* archive = io ? ziprand_open(io) : NULL;
+    if (!archive)
+        return -1;
+    if (bench_read_backend(archive, "file") != 0)
+        return -1;
+    ziprand_close(archive);
+    free(io);
+
+    /* memory backend: load the archive once, serve reads from RAM */
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    long file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = malloc((size_t)file_size);
+    if (!data || fread(data, 1, (size_t)file_size, f) != (size_t)file_size)
+        return -1;
+    fclose(f);
+
+    io = ziprand_io_memory(data, (size_t)file_size);
+    archive = io ? ziprand_open(io) : NULL;
+    if (!archive)
+        return -1;
+    if (bench_read_backend(archive, "memory") != 0)
+        return -1;
+    ziprand_close(archive);
+    free(io);
+    free(data);
+    remove(path);
+    return 0;
+}
+
+/* --- EOCD scan with a maximal comment --------------------------------- */
+
+static int bench_eocd(void)
+{
+    static const size_t comments[] = {0, 65535};
+
+    for (size_t c = 0; c < sizeof(comments) / sizeof(comments[0]); c++) {
+        char path[300];
+        bench_path(path, sizeof(path), "eocd.zip");
+        bench_zipgen_opts_t opts = {100, 16, comments[c]};
+        if (bench_zipgen_write(path, &opts) != 0)
+            return -1;
+
+        uint64_t best = UINT64_MAX;
+        uint64_t scanned = 0;
+        for (int r = 0; r < 200; r++) {
+            uint64_t t0 = now_ns();
+            ziprand_io_t* io = ziprand_io_file(path);
+            ziprand_archive_t* archive = io ? ziprand_open(io) : NULL;
+            if (!archive)
+                return -1;
+            uint64_t elapsed = now_ns() - t0;
+            ziprand_stats_t st;
+            ziprand_get_stats(archive, &st);
+            scanned = st.eocd_scan_bytes;
+            ziprand_close(archive);
+            free(io);
+            if (elapsed < best)
+                best = elapsed;
+        }
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"comment\": %zu", comments[c]);
+        emit("eocd_open", params, (double)best / 1e3, "us");
+        emit("eocd_scan", params, (double)scanned, "bytes");
+        remove(path);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    const char* tmp = getenv("TMPDIR");
+    snprintf(bench_dir, sizeof(bench_dir), "%s", tmp ? tmp : "/tmp");
+
+    printf("{\n  \"benchmarks\": [\n");
+    int rc = 0;
+    rc |= bench_open();
+    rc |= bench_lookup();
+    rc |= bench_read();
+    rc |= bench_eocd();
+    printf("\n  ]\n}\n");
+
+    if (rc != 0) {
+        fprintf(stderr, "benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
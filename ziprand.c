@@ -1,46 +1,71 @@
-#include "ziprand.h"
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L /* clock_gettime */
+#endif
+
+#include "ziprand_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
-/* ZIP signatures */
-#define EOCD_SIGNATURE               0x06054b50
-#define ZIP64_EOCD_SIGNATURE         0x06064b50
-#define ZIP64_EOCD_LOCATOR_SIGNATURE 0x07064b50
-#define CENTRAL_DIR_SIGNATURE        0x02014b50
-#define LOCAL_HEADER_SIGNATURE       0x04034b50
+/* maximum size of a single io.read when bulk-loading the central directory */
+#define CD_SLAB_SIZE (4u << 20)
 
-/* internal structures */
-struct ziprand_archive {
-    ziprand_io_t io;
-    ziprand_entry_t* entries;
-    size_t entry_count;
-    uint64_t total_size;
-};
 
-struct ziprand_file {
-    ziprand_archive_t* archive;
-    const ziprand_entry_t* entry;
-    uint64_t position;
-};
+/* entries materialized per parse_more() call on the lazy lookup path */
+#define LAZY_PARSE_CHUNK 4096
+
+/* buffered handles: first fill size and default buffer capacity; the
+ * readahead doubles from the initial size up to the capacity while the
+ * access pattern stays sequential */
+#define READAHEAD_INITIAL (16u << 10)
+#define READAHEAD_DEFAULT_CAP (256u << 10)
 
-/* utility functions */
-static inline uint16_t read_u16_le(const uint8_t* p)
+/* histogram bucket for a read of the given size: powers of four from
+ * <=1 KiB, last bucket catches everything above 4 MiB */
+static size_t stats_bucket(size_t size)
 {
-    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+    size_t bucket = 0;
+    size_t limit = 1024;
+    while (size > limit && bucket < ZIPRAND_STATS_BUCKETS - 1) {
+        limit <<= 2;
+        bucket++;
+    }
+    return bucket;
 }
 
-static inline uint32_t read_u32_le(const uint8_t* p)
+/* monotonic clock for coarse internal timing */
+static uint64_t monotonic_ns(void)
 {
-    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#ifdef _WIN32
+    return 0; /* not instrumented on this platform */
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
 }
 
-static inline uint64_t read_u64_le(const uint8_t* p)
+int64_t
+ziprand_archive_read(ziprand_archive_t* archive, uint64_t offset, void* buffer, size_t size)
 {
-    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
-           ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
-           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+    int64_t result;
+    if (archive->cache)
+        result = ziprand_cache_read(
+            archive->cache, &archive->io, archive->total_size, offset, buffer, size);
+    else
+        result = archive->io.read(archive->io.ctx, offset, buffer, size);
+
+    atomic_fetch_add_explicit(&archive->stats.reads, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(
+        &archive->stats.reads_by_bucket[stats_bucket(size)], 1, memory_order_relaxed);
+    if (result > 0)
+        atomic_fetch_add_explicit(&archive->stats.bytes_read, result, memory_order_relaxed);
+    if (archive->trace)
+        archive->trace(archive->trace_user, offset, size, result);
+
+    return result;
 }
 
 /* find End of Central Directory record */
@@ -58,25 +83,27 @@ find_eocd(ziprand_archive_t* archive, uint64_t* eocd_offset, uint16_t* num_entri
             chunk_size = sizeof(buffer);
 
         uint64_t read_pos = search_pos - chunk_size;
-        int64_t bytes_read = archive->io.read(archive->io.ctx, read_pos, buffer, chunk_size);
+        int64_t bytes_read = ziprand_archive_read(archive, read_pos, buffer, chunk_size);
 
         if (bytes_read <= 0)
             return ZIPRAND_ERR_IO;
 
-        for (int64_t i = bytes_read - 4; i >= 0; i--) {
-            uint32_t sig = read_u32_le(&buffer[i]);
-            if (sig == EOCD_SIGNATURE) {
-                *eocd_offset = read_pos + i;
-                if (i + 10 < bytes_read) {
-                    *num_entries = read_u16_le(&buffer[i + 10]);
-                } else {
-                    uint8_t entry_buf[2];
-                    if (archive->io.read(archive->io.ctx, *eocd_offset + 10, entry_buf, 2) != 2)
-                        return ZIPRAND_ERR_IO;
-                    *num_entries = read_u16_le(entry_buf);
-                }
-                return ZIPRAND_OK;
+        const uint8_t* hit = ziprand_scan_sig_rev(buffer, (size_t)bytes_read, EOCD_SIGNATURE);
+        if (hit) {
+            int64_t i = hit - buffer;
+            *eocd_offset = read_pos + i;
+            atomic_store_explicit(&archive->stats.eocd_scan_bytes,
+                                  file_size - *eocd_offset,
+                                  memory_order_relaxed);
+            if (i + 10 < bytes_read) {
+                *num_entries = read_u16_le(&buffer[i + 10]);
+            } else {
+                uint8_t entry_buf[2];
+                if (ziprand_archive_read(archive, *eocd_offset + 10, entry_buf, 2) != 2)
+                    return ZIPRAND_ERR_IO;
+                *num_entries = read_u16_le(entry_buf);
             }
+            return ZIPRAND_OK;
         }
 
         search_pos = read_pos;
@@ -87,10 +114,31 @@ find_eocd(ziprand_archive_t* archive, uint64_t* eocd_offset, uint16_t* num_entri
     return ZIPRAND_ERR_INVALID_ZIP;
 }
 
+/* read a contiguous range in slab-sized chunks; a single io.read may return
+ * short, so keep issuing reads until the range is filled */
+static ziprand_error_t
+read_fully(ziprand_archive_t* archive, uint64_t offset, uint8_t* buffer, uint64_t size)
+{
+    uint64_t done = 0;
+    while (done < size) {
+        uint64_t chunk = size - done;
+        if (chunk > CD_SLAB_SIZE)
+            chunk = CD_SLAB_SIZE;
+
+        int64_t bytes_read =
+            ziprand_archive_read(archive, offset + done, buffer + done, chunk);
+        if (bytes_read <= 0)
+            return ZIPRAND_ERR_IO;
+        done += bytes_read;
+    }
+    return ZIPRAND_OK;
+}
+
 /* read ZIP64 EOCD */
 static ziprand_error_t read_zip64_eocd(ziprand_archive_t* archive,
                                        uint64_t eocd_offset,
                                        uint64_t* cd_offset,
+                                       uint64_t* cd_size,
                                        uint64_t* num_entries)
 {
     uint8_t buffer[56];
@@ -98,7 +146,7 @@ static ziprand_error_t read_zip64_eocd(ziprand_archive_t* archive,
 
     /* find ZIP64 EOCD locator */
     uint8_t search_buf[20];
-    if (archive->io.read(archive->io.ctx, search_start, search_buf, 20) != 20)
+    if (ziprand_archive_read(archive, search_start, search_buf, 20) != 20)
         return ZIPRAND_ERR_IO;
 
     uint64_t zip64_eocd_offset = 0;
@@ -113,21 +161,24 @@ static ziprand_error_t read_zip64_eocd(ziprand_archive_t* archive,
         return ZIPRAND_ERR_INVALID_ZIP;
 
     /* read ZIP64 EOCD */
-    if (archive->io.read(archive->io.ctx, zip64_eocd_offset, buffer, 56) != 56)
+    if (ziprand_archive_read(archive, zip64_eocd_offset, buffer, 56) != 56)
         return ZIPRAND_ERR_IO;
 
     if (read_u32_le(buffer) != ZIP64_EOCD_SIGNATURE)
         return ZIPRAND_ERR_INVALID_ZIP;
 
     *cd_offset = read_u64_le(&buffer[48]);
+    *cd_size = read_u64_le(&buffer[40]);
     *num_entries = read_u64_le(&buffer[32]);
 
     return ZIPRAND_OK;
 }
 
 /* get central directory info */
-static ziprand_error_t
-get_cd_info(ziprand_archive_t* archive, uint64_t* cd_offset, uint64_t* num_entries)
+static ziprand_error_t get_cd_info(ziprand_archive_t* archive,
+                                   uint64_t* cd_offset,
+                                   uint64_t* cd_size,
+                                   uint64_t* num_entries)
 {
     uint64_t eocd_offset;
     uint16_t entries_16;
@@ -136,94 +187,85 @@ get_cd_info(ziprand_archive_t* archive, uint64_t* cd_offset, uint64_t* num_entri
         return err;
 
     uint8_t eocd_buf[22];
-    if (archive->io.read(archive->io.ctx, eocd_offset, eocd_buf, 22) != 22)
+    if (ziprand_archive_read(archive, eocd_offset, eocd_buf, 22) != 22)
         return ZIPRAND_ERR_IO;
 
+    uint32_t cd_size_32 = read_u32_le(&eocd_buf[12]);
     uint32_t cd_offset_32 = read_u32_le(&eocd_buf[16]);
 
-    if (cd_offset_32 == 0xFFFFFFFF) {
-        return read_zip64_eocd(archive, eocd_offset, cd_offset, num_entries);
+    if (cd_offset_32 == 0xFFFFFFFF || cd_size_32 == 0xFFFFFFFF || entries_16 == 0xFFFF) {
+        return read_zip64_eocd(archive, eocd_offset, cd_offset, cd_size, num_entries);
     } else {
         *cd_offset = cd_offset_32;
+        *cd_size = cd_size_32;
         *num_entries = entries_16;
         return ZIPRAND_OK;
     }
 }
 
-/* read central directory entry */
-static ziprand_error_t
-read_cd_entry(ziprand_archive_t* archive, uint64_t* offset, ziprand_entry_t* entry)
+/* parse one central directory entry out of the in-memory CD buffer; the
+ * entry name is bump-allocated from the given arena */
+static ziprand_error_t parse_cd_entry(arena_t* arena,
+                                      const uint8_t* cd,
+                                      size_t cd_size,
+                                      size_t* pos,
+                                      ziprand_entry_t* entry)
 {
-    uint8_t header[46];
-    if (archive->io.read(archive->io.ctx, *offset, header, 46) != 46)
-        return ZIPRAND_ERR_IO;
+    if (*pos + 46 > cd_size)
+        return ZIPRAND_ERR_INVALID_ZIP;
 
+    const uint8_t* header = cd + *pos;
     if (read_u32_le(header) != CENTRAL_DIR_SIGNATURE)
         return ZIPRAND_ERR_INVALID_ZIP;
 
     entry->compression_method = read_u16_le(&header[10]);
+    entry->crc32 = read_u32_le(&header[16]);
     uint16_t filename_len = read_u16_le(&header[28]);
     uint16_t extra_len = read_u16_le(&header[30]);
     uint16_t comment_len = read_u16_le(&header[32]);
 
+    if (*pos + 46 + (size_t)filename_len + extra_len + comment_len > cd_size)
+        return ZIPRAND_ERR_INVALID_ZIP;
+
     uint64_t compressed_size = read_u32_le(&header[20]);
     uint64_t uncompressed_size = read_u32_le(&header[24]);
     uint64_t local_offset = read_u32_le(&header[42]);
 
-    /* Read filename */
-    entry->name = malloc(filename_len + 1);
+    entry->name = arena_alloc(arena, (size_t)filename_len + 1);
     if (!entry->name)
         return ZIPRAND_ERR_NOMEM;
-
-    if (archive->io.read(archive->io.ctx, *offset + 46, entry->name, filename_len) !=
-        filename_len) {
-        free(entry->name);
-        return ZIPRAND_ERR_IO;
-    }
+    memcpy(entry->name, header + 46, filename_len);
     entry->name[filename_len] = '\0';
 
-    /* read extra field for ZIP64 */
+    /* parse extra field for ZIP64 */
     if (extra_len > 0) {
-        uint8_t* extra = malloc(extra_len);
-        if (!extra) {
-            free(entry->name);
-            return ZIPRAND_ERR_NOMEM;
-        }
-
-        if (archive->io.read(archive->io.ctx, *offset + 46 + filename_len, extra, extra_len) !=
-            extra_len) {
-            free(extra);
-            free(entry->name);
-            return ZIPRAND_ERR_IO;
-        }
+        const uint8_t* extra = header + 46 + filename_len;
 
-        /* parse ZIP64 extra field */
         if (uncompressed_size == 0xFFFFFFFF || compressed_size == 0xFFFFFFFF ||
             local_offset == 0xFFFFFFFF) {
-            size_t pos = 0;
-            while (pos + 4 <= extra_len) {
-                uint16_t header_id = read_u16_le(&extra[pos]);
-                uint16_t data_size = read_u16_le(&extra[pos + 2]);
+            size_t epos = 0;
+            while (epos + 4 <= extra_len) {
+                uint16_t header_id = read_u16_le(&extra[epos]);
+                uint16_t data_size = read_u16_le(&extra[epos + 2]);
 
                 if (header_id == 0x0001) {
-                    size_t field_pos = pos + 4;
-                    if (uncompressed_size == 0xFFFFFFFF && field_pos + 8 <= pos + 4 + data_size) {
+                    size_t field_pos = epos + 4;
+                    if (uncompressed_size == 0xFFFFFFFF && field_pos + 8 <= epos + 4 + data_size) {
                         uncompressed_size = read_u64_le(&extra[field_pos]);
                         field_pos += 8;
                     }
-                    if (compressed_size == 0xFFFFFFFF && field_pos + 8 <= pos + 4 + data_size) {
+                    if (compressed_size == 0xFFFFFFFF && field_pos + 8 <= epos + 4 + data_size) {
                         compressed_size = read_u64_le(&extra[field_pos]);
                         field_pos += 8;
                     }
-                    if (local_offset == 0xFFFFFFFF && field_pos + 8 <= pos + 4 + data_size) {
+                    if (local_offset == 0xFFFFFFFF && field_pos + 8 <= epos + 4 + data_size) {
                         local_offset = read_u64_le(&extra[field_pos]);
                     }
                     break;
                 }
-                pos += 4 + data_size;
+                epos += 4 + data_size;
             }
         }
-        free(extra);
     }
 
     entry->compressed_size = compressed_size;
@@ -231,15 +273,121 @@ read_cd_entry(ziprand_archive_t* archive, uint64_t* offset, ziprand_entry_t* ent
     entry->offset = local_offset;
     entry->data_offset = 0; /* will be calculated later */
 
-    *offset += 46 + filename_len + extra_len + comment_len;
+    *pos += 46 + (size_t)filename_len + extra_len + comment_len;
+    return ZIPRAND_OK;
+}
+
+ziprand_error_t ziprand_columns_alloc(ziprand_archive_t* archive, size_t count)
+{
+    size_t names_bytes = count * sizeof(char*);
+    size_t u64_bytes = count * sizeof(uint64_t);
+    size_t total =
+        names_bytes + 4 * u64_bytes + count * (sizeof(uint16_t) + sizeof(uint32_t));
+
+    uint8_t* block = calloc(1, total ? total : 1);
+    if (!block)
+        return ZIPRAND_ERR_NOMEM;
+
+    archive->cols.names = (char**)block;
+    archive->cols.compressed_sizes = (uint64_t*)(block + names_bytes);
+    archive->cols.uncompressed_sizes = (uint64_t*)(block + names_bytes + u64_bytes);
+    archive->cols.offsets = (uint64_t*)(block + names_bytes + 2 * u64_bytes);
+    archive->cols.data_offsets = (uint64_t*)(block + names_bytes + 3 * u64_bytes);
+    archive->cols.crc32s = (uint32_t*)(block + names_bytes + 4 * u64_bytes);
+    archive->cols.methods =
+        (uint16_t*)(block + names_bytes + 4 * u64_bytes + count * sizeof(uint32_t));
+    return ZIPRAND_OK;
+}
+
+/* scatter one parsed record into the columns */
+static void columns_set(ziprand_archive_t* archive, size_t index, const ziprand_entry_t* entry)
+{
+    archive->cols.names[index] = entry->name;
+    archive->cols.compressed_sizes[index] = entry->compressed_size;
+    archive->cols.uncompressed_sizes[index] = entry->uncompressed_size;
+    archive->cols.offsets[index] = entry->offset;
+    archive->cols.data_offsets[index] = entry->data_offset;
+    archive->cols.methods[index] = entry->compression_method;
+    archive->cols.crc32s[index] = entry->crc32;
+}
+
+/* materialize the public view of an entry from the columns; the data
+ * offset is refreshed on every call since it resolves lazily */
+static const ziprand_entry_t* entry_view(ziprand_archive_t* archive, size_t index)
+{
+    ziprand_entry_t* view = &archive->entries[index];
+    if (!view->name) {
+        view->name = archive->cols.names[index];
+        view->compressed_size = archive->cols.compressed_sizes[index];
+        view->uncompressed_size = archive->cols.uncompressed_sizes[index];
+        view->offset = archive->cols.offsets[index];
+        view->compression_method = archive->cols.methods[index];
+        view->crc32 = archive->cols.crc32s[index];
+    }
+    view->data_offset = archive->cols.data_offsets[index];
+    return view;
+}
+
+/* FNV-1a hash over an entry name */
+static uint64_t hash_name(const char* name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/* allocate the name -> entry index hash table (linear probing), sized for
+ * the full entry count so it never needs resizing. The table only ever
+ * grows by inserts, so once an opener is done filling it, lookups are
+ * read-only and concurrent readers need no locking. */
+static ziprand_error_t name_index_alloc(ziprand_archive_t* archive, size_t entry_count)
+{
+    size_t buckets = 16;
+    while (buckets < entry_count * 2)
+        buckets <<= 1;
+
+    archive->name_index = malloc(buckets * sizeof(uint32_t));
+    if (!archive->name_index)
+        return ZIPRAND_ERR_NOMEM;
+    archive->name_index_size = buckets;
+
+    memset(archive->name_index, 0xFF, buckets * sizeof(uint32_t));
+    return ZIPRAND_OK;
+}
+
+/* insert one entry; duplicate names keep the first occurrence to match
+ * the old linear-scan semantics */
+static void name_index_insert(ziprand_archive_t* archive, uint32_t index)
+{
+    size_t slot = hash_name(archive->cols.names[index]) & (archive->name_index_size - 1);
+    while (archive->name_index[slot] != NAME_INDEX_EMPTY) {
+        if (strcmp(archive->cols.names[archive->name_index[slot]],
+                   archive->cols.names[index]) == 0)
+            return; /* duplicate name, keep first occurrence */
+        slot = (slot + 1) & (archive->name_index_size - 1);
+    }
+    archive->name_index[slot] = index;
+}
+
+ziprand_error_t ziprand_name_index_build(ziprand_archive_t* archive, size_t count)
+{
+    ziprand_error_t err = name_index_alloc(archive, count);
+    if (err != ZIPRAND_OK)
+        return err;
+    for (size_t i = 0; i < count; i++)
+        name_index_insert(archive, (uint32_t)i);
     return ZIPRAND_OK;
 }
 
 /* calculate data offset for an entry */
-static ziprand_error_t get_data_offset(ziprand_archive_t* archive, ziprand_entry_t* entry)
+static ziprand_error_t get_data_offset(ziprand_archive_t* archive, size_t index)
 {
+    uint64_t offset = archive->cols.offsets[index];
     uint8_t local_header[30];
-    if (archive->io.read(archive->io.ctx, entry->offset, local_header, 30) != 30)
+    if (ziprand_archive_read(archive, offset, local_header, 30) != 30)
         return ZIPRAND_ERR_IO;
 
     if (read_u32_le(local_header) != LOCAL_HEADER_SIGNATURE)
@@ -248,13 +396,262 @@ static ziprand_error_t get_data_offset(ziprand_archive_t* archive, ziprand_entry
     uint16_t filename_len = read_u16_le(&local_header[26]);
     uint16_t extra_len = read_u16_le(&local_header[28]);
 
-    entry->data_offset = entry->offset + 30 + filename_len + extra_len;
+    archive->cols.data_offsets[index] = offset + 30 + filename_len + extra_len;
     return ZIPRAND_OK;
 }
 
-/* public API implementation */
+/* parse up to max_entries further CD records on the lazy path, sliding the
+ * CD window forward as records are consumed */
+static ziprand_error_t parse_more(ziprand_archive_t* archive, size_t max_entries)
+{
+    if (!archive->cd_window) {
+        archive->cd_window = malloc(CD_SLAB_SIZE);
+        if (!archive->cd_window)
+            return ZIPRAND_ERR_NOMEM;
+        archive->cd_window_len = 0;
+        archive->cd_window_pos = 0;
+    }
 
-ziprand_archive_t* ziprand_open(const ziprand_io_t* io)
+    uint64_t parse_start = monotonic_ns();
+
+    for (size_t n = 0; n < max_entries && archive->parsed_count < archive->entry_count; n++) {
+        uint64_t unread = archive->cd_size - archive->cd_consumed;
+        size_t avail = archive->cd_window_len - archive->cd_window_pos;
+
+        /* refill the window when the next record is not fully buffered */
+        int need_refill = 0;
+        if (avail < 46) {
+            need_refill = unread > avail;
+        } else {
+            const uint8_t* header = archive->cd_window + archive->cd_window_pos;
+            size_t record_len = 46 + (size_t)read_u16_le(&header[28]) + read_u16_le(&header[30]) +
+                                read_u16_le(&header[32]);
+            if (avail < record_len)
+                need_refill = unread > avail;
+        }
+        if (need_refill) {
+            size_t to_read = unread < CD_SLAB_SIZE ? (size_t)unread : CD_SLAB_SIZE;
+            ziprand_error_t err = read_fully(
+                archive, archive->cd_offset + archive->cd_consumed, archive->cd_window, to_read);
+            if (err != ZIPRAND_OK)
+                return err;
+            archive->cd_window_len = to_read;
+            archive->cd_window_pos = 0;
+        }
+
+        size_t before = archive->cd_window_pos;
+        ziprand_entry_t record;
+        ziprand_error_t err = parse_cd_entry(&archive->arena,
+                                             archive->cd_window,
+                                             archive->cd_window_len,
+                                             &archive->cd_window_pos,
+                                             &record);
+        if (err != ZIPRAND_OK)
+            return err;
+
+        archive->cd_consumed += archive->cd_window_pos - before;
+        columns_set(archive, archive->parsed_count, &record);
+        name_index_insert(archive, (uint32_t)archive->parsed_count);
+        archive->parsed_count++;
+    }
+
+    atomic_fetch_add_explicit(
+        &archive->stats.cd_parse_ns, monotonic_ns() - parse_start, memory_order_relaxed);
+    return ZIPRAND_OK;
+}
+
+/* materialize lazy entries at least up to and including index */
+static ziprand_error_t ensure_parsed(ziprand_archive_t* archive, size_t index)
+{
+    if (index >= archive->entry_count)
+        index = archive->entry_count - 1;
+    while (archive->parsed_count <= index) {
+        if (archive->cd_error)
+            return ZIPRAND_ERR_INVALID_ZIP;
+        ziprand_error_t err = parse_more(archive, LAZY_PARSE_CHUNK);
+        if (err != ZIPRAND_OK) {
+            archive->cd_error = 1;
+            return err;
+        }
+    }
+    return ZIPRAND_OK;
+}
+
+ziprand_error_t ziprand_archive_parse_all(ziprand_archive_t* archive)
+{
+    if (!archive->lazy || archive->entry_count == 0 ||
+        archive->parsed_count == archive->entry_count)
+        return ZIPRAND_OK;
+    return ensure_parsed(archive, archive->entry_count - 1);
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+#include <unistd.h>
+
+/* parallel CD parsing kicks in above this entry count */
+#define PARALLEL_PARSE_MIN_ENTRIES 4096
+/* and each worker gets at least this much CD to chew on */
+#define PARALLEL_PARSE_MIN_CHUNK (256u << 10)
+#define PARALLEL_PARSE_MAX_THREADS 64
+
+typedef struct {
+    const uint8_t* cd;
+    size_t cd_size;
+    size_t start; /* first byte of this worker's slice */
+    size_t end;   /* records starting before end belong to this worker */
+    ziprand_entry_t* entries;
+    size_t count;
+    size_t cap;
+    arena_t arena;
+    int error;
+} cd_worker_t;
+
+static void* cd_worker_run(void* arg)
+{
+    cd_worker_t* worker = arg;
+    size_t pos = worker->start;
+
+    /* CD records are self-delimiting: skip forward to the first record
+     * signature in this slice (worker 0 starts exactly on one). Scan a few
+     * bytes past end so a signature beginning on the last slice bytes is
+     * still found; the record itself may extend into the next slice. */
+    if (pos > 0) {
+        size_t limit = worker->end + 3 < worker->cd_size ? worker->end + 3 : worker->cd_size;
+        const uint8_t* hit =
+            ziprand_scan_sig(worker->cd + pos, limit - pos, CENTRAL_DIR_SIGNATURE);
+        if (!hit)
+            return NULL; /* slice holds no record starts */
+        pos = (size_t)(hit - worker->cd);
+    }
+
+    while (pos < worker->end) {
+        if (worker->count == worker->cap) {
+            size_t cap = worker->cap ? worker->cap * 2 : 1024;
+            ziprand_entry_t* entries = realloc(worker->entries, cap * sizeof(ziprand_entry_t));
+            if (!entries) {
+                worker->error = 1;
+                return NULL;
+            }
+            worker->entries = entries;
+            worker->cap = cap;
+        }
+
+        if (parse_cd_entry(
+                &worker->arena, worker->cd, worker->cd_size, &pos, &worker->entries[worker->count]) !=
+            ZIPRAND_OK) {
+            worker->error = 1;
+            return NULL;
+        }
+        worker->count++;
+    }
+
+    return NULL;
+}
+
+/* parse the CD buffer with nthreads workers; the stitched result must
+ * account for exactly num_entries records or the attempt is abandoned
+ * (caller falls back to the serial parse) */
+static ziprand_error_t parse_cd_parallel(ziprand_archive_t* archive,
+                                         const uint8_t* cd,
+                                         uint64_t num_entries,
+                                         int nthreads)
+{
+    size_t cd_size = (size_t)archive->cd_size;
+    cd_worker_t* workers = calloc(nthreads, sizeof(cd_worker_t));
+    if (!workers)
+        return ZIPRAND_ERR_NOMEM;
+
+    pthread_t* tids = calloc(nthreads, sizeof(pthread_t));
+    if (!tids) {
+        free(workers);
+        return ZIPRAND_ERR_NOMEM;
+    }
+
+    size_t chunk = cd_size / nthreads;
+    for (int t = 0; t < nthreads; t++) {
+        workers[t].cd = cd;
+        workers[t].cd_size = cd_size;
+        workers[t].start = chunk * t;
+        workers[t].end = t == nthreads - 1 ? cd_size : chunk * (t + 1);
+    }
+
+    int spawned = 0;
+    for (; spawned < nthreads; spawned++) {
+        if (pthread_create(&tids[spawned], NULL, cd_worker_run, &workers[spawned]) != 0)
+            break;
+    }
+    for (int t = 0; t < spawned; t++)
+        pthread_join(tids[t], NULL);
+    free(tids);
+
+    uint64_t total = 0;
+    int failed = spawned < nthreads;
+    for (int t = 0; t < nthreads; t++) {
+        if (workers[t].error)
+            failed = 1;
+        total += workers[t].count;
+    }
+
+    if (failed || total != num_entries) {
+        /* a signature false-positive or mid-record split surfaced as a
+         * parse error or count mismatch; discard everything */
+        for (int t = 0; t < nthreads; t++) {
+            arena_destroy(&workers[t].arena);
+            free(workers[t].entries);
+        }
+        free(workers);
+        return ZIPRAND_ERR_INVALID_ZIP;
+    }
+
+    size_t out = 0;
+    for (int t = 0; t < nthreads; t++) {
+        for (size_t k = 0; k < workers[t].count; k++)
+            columns_set(archive, out + k, &workers[t].entries[k]);
+        out += workers[t].count;
+        arena_splice(&archive->arena, &workers[t].arena);
+        free(workers[t].entries);
+    }
+    free(workers);
+
+    return ZIPRAND_OK;
+}
+
+/* pick the worker count for parallel CD parsing: bounded by cores, the
+ * caller's cap, and a minimum amount of CD per thread */
+static int resolve_parse_threads(const ziprand_open_opts_t* opts, uint64_t cd_size)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int nthreads = cores > 0 ? (int)cores : 1;
+
+    if (opts && opts->threads > 0 && nthreads > opts->threads)
+        nthreads = opts->threads;
+    if (nthreads > PARALLEL_PARSE_MAX_THREADS)
+        nthreads = PARALLEL_PARSE_MAX_THREADS;
+    if ((uint64_t)nthreads > cd_size / PARALLEL_PARSE_MIN_CHUNK)
+        nthreads = (int)(cd_size / PARALLEL_PARSE_MIN_CHUNK);
+    return nthreads > 1 ? nthreads : 1;
+}
+
+#endif /* !_WIN32 */
+
+/* destroy a partially constructed archive without touching the caller's io */
+static void archive_abort(ziprand_archive_t* archive)
+{
+    arena_destroy(&archive->arena);
+    ziprand_cache_free(archive->cache);
+    free(archive->cols.names);
+    free(archive->entries);
+    free(archive->name_index);
+    free(archive->name_order);
+    free(archive);
+}
+
+/* common open path: allocate the handle, attach the optional block cache
+ * and locate the central directory */
+static ziprand_archive_t*
+archive_new(const ziprand_io_t* io, const ziprand_open_opts_t* opts, uint64_t* num_entries)
 {
     if (!io || !io->read || !io->get_size)
         return NULL;
@@ -265,51 +662,236 @@ ziprand_archive_t* ziprand_open(const ziprand_io_t* io)
 
     archive->io = *io;
 
+    if (opts)
+        archive->verify = opts->verify;
+
+    if (opts && opts->cache_blocks > 0) {
+        archive->cache = ziprand_cache_new(opts->cache_block_size, opts->cache_blocks);
+        if (!archive->cache) {
+            free(archive);
+            return NULL;
+        }
+    }
+
     int64_t size = archive->io.get_size(archive->io.ctx);
     if (size < 0) {
-        free(archive);
+        archive_abort(archive);
         return NULL;
     }
     archive->total_size = size;
 
-    uint64_t cd_offset, num_entries;
-    if (get_cd_info(archive, &cd_offset, &num_entries) != ZIPRAND_OK) {
-        free(archive);
+    if (get_cd_info(archive, &archive->cd_offset, &archive->cd_size, num_entries) != ZIPRAND_OK) {
+        archive_abort(archive);
+        return NULL;
+    }
+
+    if (archive->cd_offset + archive->cd_size > archive->total_size) {
+        archive_abort(archive);
         return NULL;
     }
 
+    return archive;
+}
+
+/* public API implementation */
+
+ziprand_archive_t* ziprand_open_ex(const ziprand_io_t* io, const ziprand_open_opts_t* opts)
+{
+    uint64_t num_entries;
+    ziprand_archive_t* archive = archive_new(io, opts, &num_entries);
+    if (!archive)
+        return NULL;
+
     archive->entries = calloc(num_entries, sizeof(ziprand_entry_t));
     if (!archive->entries) {
-        free(archive);
+        archive_abort(archive);
+        return NULL;
+    }
+    archive->entry_count = num_entries;
+
+    if (ziprand_columns_alloc(archive, num_entries) != ZIPRAND_OK) {
+        archive_abort(archive);
+        return NULL;
+    }
+
+    if (name_index_alloc(archive, num_entries) != ZIPRAND_OK) {
+        archive_abort(archive);
+        return NULL;
+    }
+
+    if (opts && opts->lazy) {
+        /* defer CD parsing entirely: the (zero-filled, lazily paged) entry
+         * table and index fill in as lookups materialize records */
+        archive->lazy = 1;
+        return archive;
+    }
+
+    /* bulk-load the whole central directory and parse it out of memory,
+     * so opening costs O(cd_size / slab) reads instead of O(entries) */
+    uint8_t* cd = malloc(archive->cd_size ? archive->cd_size : 1);
+    if (!cd) {
+        archive_abort(archive);
+        return NULL;
+    }
+    if (read_fully(archive, archive->cd_offset, cd, archive->cd_size) != ZIPRAND_OK) {
+        free(cd);
+        archive_abort(archive);
         return NULL;
     }
 
-    uint64_t offset = cd_offset;
+    uint64_t parse_start = monotonic_ns();
+
+#ifndef _WIN32
+    if ((!opts || opts->threads != 1) && num_entries >= PARALLEL_PARSE_MIN_ENTRIES) {
+        int nthreads = resolve_parse_threads(opts, archive->cd_size);
+        if (nthreads > 1 && parse_cd_parallel(archive, cd, num_entries, nthreads) == ZIPRAND_OK) {
+            free(cd);
+            for (size_t i = 0; i < num_entries; i++)
+                name_index_insert(archive, (uint32_t)i);
+            archive->parsed_count = num_entries;
+            atomic_fetch_add_explicit(&archive->stats.cd_parse_ns,
+                                      monotonic_ns() - parse_start,
+                                      memory_order_relaxed);
+            return archive;
+        }
+        /* any worker failure or count mismatch falls back to the serial parse */
+    }
+#endif
+
+    size_t pos = 0;
     for (size_t i = 0; i < num_entries; i++) {
-        if (read_cd_entry(archive, &offset, &archive->entries[i]) != ZIPRAND_OK) {
-            for (size_t j = 0; j < i; j++)
-                free(archive->entries[j].name);
-            free(archive->entries);
-            free(archive);
+        ziprand_entry_t record;
+        if (parse_cd_entry(&archive->arena, cd, archive->cd_size, &pos, &record) != ZIPRAND_OK) {
+            free(cd);
+            archive_abort(archive);
             return NULL;
         }
+        columns_set(archive, i, &record);
+        name_index_insert(archive, (uint32_t)i);
     }
+    free(cd);
 
-    archive->entry_count = num_entries;
+    archive->parsed_count = num_entries;
+    atomic_fetch_add_explicit(
+        &archive->stats.cd_parse_ns, monotonic_ns() - parse_start, memory_order_relaxed);
     return archive;
 }
 
+ziprand_archive_t* ziprand_open(const ziprand_io_t* io)
+{
+    return ziprand_open_ex(io, NULL);
+}
+
+ziprand_archive_t* ziprand_open_lazy(const ziprand_io_t* io)
+{
+    ziprand_open_opts_t opts = {0};
+    opts.lazy = 1;
+    return ziprand_open_ex(io, &opts);
+}
+
+typedef struct {
+    uint64_t offset;
+    uint32_t index;
+} resolve_item_t;
+
+static int resolve_order_cmp(const void* a, const void* b)
+{
+    const resolve_item_t* ia = a;
+    const resolve_item_t* ib = b;
+    if (ia->offset < ib->offset)
+        return -1;
+    return ia->offset > ib->offset;
+}
+
+ziprand_error_t ziprand_resolve_offsets(ziprand_archive_t* archive)
+{
+    if (!archive)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    ziprand_error_t err = ziprand_archive_parse_all(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    size_t pending = 0;
+    for (size_t i = 0; i < archive->entry_count; i++) {
+        if (archive->cols.data_offsets[i] == 0)
+            pending++;
+    }
+    if (pending == 0)
+        return ZIPRAND_OK;
+
+    /* visit local headers in file order so reads coalesce into slabs */
+    resolve_item_t* order = malloc(pending * sizeof(resolve_item_t));
+    if (!order)
+        return ZIPRAND_ERR_NOMEM;
+    size_t n = 0;
+    for (size_t i = 0; i < archive->entry_count; i++) {
+        if (archive->cols.data_offsets[i] == 0) {
+            order[n].offset = archive->cols.offsets[i];
+            order[n].index = (uint32_t)i;
+            n++;
+        }
+    }
+    qsort(order, pending, sizeof(resolve_item_t), resolve_order_cmp);
+
+    uint8_t* slab = malloc(CD_SLAB_SIZE);
+    if (!slab) {
+        free(order);
+        return ZIPRAND_ERR_NOMEM;
+    }
+
+    size_t i = 0;
+    while (i < pending && err == ZIPRAND_OK) {
+        uint64_t base = order[i].offset;
+        if (base + 30 > archive->total_size) {
+            err = ZIPRAND_ERR_INVALID_ZIP;
+            break;
+        }
+
+        uint64_t span = archive->total_size - base;
+        size_t slab_len = span < CD_SLAB_SIZE ? (size_t)span : CD_SLAB_SIZE;
+        if (read_fully(archive, base, slab, slab_len) != ZIPRAND_OK) {
+            err = ZIPRAND_ERR_IO;
+            break;
+        }
+
+        /* consume every header fully covered by this slab; a straddling
+         * header starts the next slab at its own offset */
+        while (i < pending && order[i].offset + 30 <= base + slab_len) {
+            const uint8_t* header = slab + (size_t)(order[i].offset - base);
+            if (read_u32_le(header) != LOCAL_HEADER_SIGNATURE) {
+                err = ZIPRAND_ERR_INVALID_ZIP;
+                break;
+            }
+            archive->cols.data_offsets[order[i].index] =
+                order[i].offset + 30 + read_u16_le(&header[26]) + read_u16_le(&header[28]);
+            i++;
+        }
+    }
+
+    free(slab);
+    free(order);
+    return err;
+}
+
 void ziprand_close(ziprand_archive_t* archive)
 {
     if (!archive)
         return;
 
+    /* shared handles only tear down once the last holder closes */
+    if (archive->cached && ziprand_cached_release(archive) > 0)
+        return;
+
     if (archive->io.close)
         archive->io.close(archive->io.ctx);
 
-    for (size_t i = 0; i < archive->entry_count; i++)
-        free(archive->entries[i].name);
-
+    arena_destroy(&archive->arena);
+    ziprand_cache_free(archive->cache);
+    free(archive->cd_window);
+    free(archive->name_index);
+    free(archive->name_order);
+    free(archive->cols.names);
     free(archive->entries);
     free(archive);
 }
@@ -323,7 +905,9 @@ const ziprand_entry_t* ziprand_get_entry_by_index(ziprand_archive_t* archive, si
 {
     if (!archive || index >= archive->entry_count)
         return NULL;
-    return &archive->entries[index];
+    if (archive->lazy && ensure_parsed(archive, index) != ZIPRAND_OK)
+        return NULL;
+    return entry_view(archive, index);
 }
 
 const ziprand_entry_t* ziprand_find_entry(ziprand_archive_t* archive, const char* name)
@@ -331,36 +915,419 @@ const ziprand_entry_t* ziprand_find_entry(ziprand_archive_t* archive, const char
     if (!archive || !name)
         return NULL;
 
-    for (size_t i = 0; i < archive->entry_count; i++) {
-        if (strcmp(archive->entries[i].name, name) == 0)
-            return &archive->entries[i];
+    atomic_fetch_add_explicit(&archive->stats.lookups, 1, memory_order_relaxed);
+
+    for (;;) {
+        size_t slot = hash_name(name) & (archive->name_index_size - 1);
+        while (archive->name_index[slot] != NAME_INDEX_EMPTY) {
+            uint32_t index = archive->name_index[slot];
+            if (strcmp(archive->cols.names[index], name) == 0) {
+                atomic_fetch_add_explicit(
+                    &archive->stats.lookups_found, 1, memory_order_relaxed);
+                return entry_view(archive, index);
+            }
+            slot = (slot + 1) & (archive->name_index_size - 1);
+        }
+
+        /* not found among materialized entries; in lazy mode parse further
+         * CD records and probe again */
+        if (!archive->lazy || archive->parsed_count >= archive->entry_count)
+            return NULL;
+        if (ensure_parsed(archive, archive->parsed_count + LAZY_PARSE_CHUNK - 1) != ZIPRAND_OK)
+            return NULL;
     }
-    return NULL;
 }
 
-ziprand_file_t* ziprand_fopen(ziprand_archive_t* archive, const ziprand_entry_t* entry)
+/* how many lookups ziprand_find_entries keeps in flight: enough to hide
+ * a hash-table cache miss behind the hashing of later names */
+#define FIND_BATCH_WINDOW 8
+
+#if defined(__GNUC__)
+#define find_prefetch(addr) __builtin_prefetch((addr), 0, 1)
+#else
+#define find_prefetch(addr) ((void)0)
+#endif
+
+ziprand_error_t ziprand_find_entries(ziprand_archive_t* archive,
+                                     const char* const* names,
+                                     size_t count,
+                                     const ziprand_entry_t** out)
+{
+    if (!archive || (count > 0 && (!names || !out)))
+        return ZIPRAND_ERR_INVALID_PARAM;
+    if (count == 0)
+        return ZIPRAND_OK;
+
+    /* materialize every entry once instead of letting each miss fall
+     * into the lazy parse-and-reprobe loop */
+    ziprand_error_t err = ziprand_archive_parse_all(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    size_t mask = archive->name_index_size - 1;
+    uint64_t found = 0;
+
+    size_t slots[FIND_BATCH_WINDOW];
+    for (size_t base = 0; base < count; base += FIND_BATCH_WINDOW) {
+        size_t batch = count - base;
+        if (batch > FIND_BATCH_WINDOW)
+            batch = FIND_BATCH_WINDOW;
+
+        /* pass 1: hash the window and touch every home slot, so by the
+         * time the probes run the table lines are already in flight */
+        for (size_t j = 0; j < batch; j++) {
+            const char* name = names[base + j];
+            slots[j] = name ? hash_name(name) & mask : (size_t)-1;
+            if (name)
+                find_prefetch(&archive->name_index[slots[j]]);
+        }
+
+        /* pass 2: resolve the window with the usual linear probe */
+        for (size_t j = 0; j < batch; j++) {
+            const char* name = names[base + j];
+            out[base + j] = NULL;
+            if (!name)
+                continue;
+
+            size_t slot = slots[j];
+            while (archive->name_index[slot] != NAME_INDEX_EMPTY) {
+                uint32_t index = archive->name_index[slot];
+                if (strcmp(archive->cols.names[index], name) == 0) {
+                    out[base + j] = entry_view(archive, index);
+                    found++;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+    }
+
+    atomic_fetch_add_explicit(&archive->stats.lookups, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&archive->stats.lookups_found, found, memory_order_relaxed);
+    return ZIPRAND_OK;
+}
+
+typedef struct {
+    const char* name;
+    uint32_t index;
+} name_order_item_t;
+
+static int name_order_cmp(const void* a, const void* b)
+{
+    return strcmp(((const name_order_item_t*)a)->name, ((const name_order_item_t*)b)->name);
+}
+
+/* build the name-sorted secondary index on first use; the entry table is
+ * immutable once fully parsed, so the order never needs invalidating */
+static ziprand_error_t build_name_order(ziprand_archive_t* archive)
+{
+    if (archive->name_order)
+        return ZIPRAND_OK;
+
+    ziprand_error_t err = ziprand_archive_parse_all(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    size_t count = archive->entry_count;
+    name_order_item_t* items = malloc(count * sizeof(name_order_item_t));
+    uint32_t* order = malloc(count ? count * sizeof(uint32_t) : 1);
+    if (!items || !order) {
+        free(items);
+        free(order);
+        return ZIPRAND_ERR_NOMEM;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        items[i].name = archive->cols.names[i];
+        items[i].index = (uint32_t)i;
+    }
+    qsort(items, count, sizeof(name_order_item_t), name_order_cmp);
+
+    for (size_t i = 0; i < count; i++)
+        order[i] = items[i].index;
+    free(items);
+
+    archive->name_order = order;
+    return ZIPRAND_OK;
+}
+
+int64_t ziprand_list_prefix(ziprand_archive_t* archive,
+                            const char* prefix,
+                            ziprand_list_fn callback,
+                            void* user)
+{
+    if (!archive || !prefix || !callback)
+        return -1;
+    if (build_name_order(archive) != ZIPRAND_OK)
+        return -1;
+
+    /* lower bound: first sorted position whose name is >= prefix */
+    size_t prefix_len = strlen(prefix);
+    size_t lo = 0;
+    size_t hi = archive->entry_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(archive->cols.names[archive->name_order[mid]], prefix) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    int64_t matched = 0;
+    for (size_t i = lo; i < archive->entry_count; i++) {
+        uint32_t index = archive->name_order[i];
+        if (strncmp(archive->cols.names[index], prefix, prefix_len) != 0)
+            break;
+        matched++;
+        if (callback(entry_view(archive, index), user) != 0)
+            break;
+    }
+    return matched;
+}
+
+int64_t ziprand_enumerate(const ziprand_io_t* io, ziprand_list_fn callback, void* user)
+{
+    if (!io || !io->read || !io->get_size || !callback)
+        return -1;
+
+    /* a transient archive shell gives the EOCD/CD helpers something to
+     * read through; nothing of it survives this call */
+    ziprand_archive_t probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.io = *io;
+
+    int64_t size = io->get_size(io->ctx);
+    if (size < 0)
+        return -1;
+    probe.total_size = (uint64_t)size;
+
+    uint64_t cd_offset, cd_size, num_entries;
+    if (get_cd_info(&probe, &cd_offset, &cd_size, &num_entries) != ZIPRAND_OK)
+        return -1;
+
+    uint8_t* window = malloc(cd_size < CD_SLAB_SIZE ? (cd_size ? (size_t)cd_size : 1)
+                                                    : CD_SLAB_SIZE);
+    if (!window)
+        return -1;
+
+    /* one reusable arena block backs the transient name; it is reset
+     * after every callback, so memory stays constant however many
+     * entries stream past */
+    arena_t arena = {0};
+
+    int64_t visited = 0;
+    uint64_t consumed = 0;
+    size_t window_len = 0;
+    size_t window_pos = 0;
+    int failed = 0;
+
+    for (uint64_t i = 0; i < num_entries; i++) {
+        uint64_t unread = cd_size - consumed;
+        size_t avail = window_len - window_pos;
+
+        /* refill when the next record is not fully buffered (same sliding
+         * scheme as the lazy parse path) */
+        int need_refill = 0;
+        if (avail < 46) {
+            need_refill = unread > avail;
+        } else {
+            const uint8_t* header = window + window_pos;
+            size_t record_len = 46 + (size_t)read_u16_le(&header[28]) + read_u16_le(&header[30]) +
+                                read_u16_le(&header[32]);
+            if (avail < record_len)
+                need_refill = unread > avail;
+        }
+        if (need_refill) {
+            size_t to_read = unread < CD_SLAB_SIZE ? (size_t)unread : CD_SLAB_SIZE;
+            if (read_fully(&probe, cd_offset + consumed, window, to_read) != ZIPRAND_OK) {
+                failed = 1;
+                break;
+            }
+            window_len = to_read;
+            window_pos = 0;
+        }
+
+        size_t before = window_pos;
+        ziprand_entry_t record;
+        if (parse_cd_entry(&arena, window, window_len, &window_pos, &record) != ZIPRAND_OK) {
+            failed = 1;
+            break;
+        }
+        consumed += window_pos - before;
+
+        visited++;
+        int stop = callback(&record, user);
+        if (arena.head)
+            arena.head->used = 0; /* recycle the name allocation */
+        if (stop)
+            break;
+    }
+
+    arena_destroy(&arena);
+    free(window);
+    return failed ? -1 : visited;
+}
+
+ziprand_error_t ziprand_get_columns(ziprand_archive_t* archive, ziprand_entry_columns_t* out)
+{
+    if (!archive || !out)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    /* a lazy archive must be fully materialized before handing out the
+     * columns, or unparsed slots would read as empty entries */
+    ziprand_error_t err = ziprand_archive_parse_all(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    out->names = (const char* const*)archive->cols.names;
+    out->compressed_sizes = archive->cols.compressed_sizes;
+    out->uncompressed_sizes = archive->cols.uncompressed_sizes;
+    out->offsets = archive->cols.offsets;
+    out->compression_methods = archive->cols.methods;
+    out->crc32s = archive->cols.crc32s;
+    out->count = archive->entry_count;
+    return ZIPRAND_OK;
+}
+
+/* shared open path: validate the entry, resolve its data offset and
+ * initialize the handle fields in caller-provided memory */
+/* compression methods the read paths can serve in this build */
+static int method_supported(uint16_t method)
+{
+    if (method == 0)
+        return 1;
+#ifdef ZIPRAND_HAVE_ZLIB
+    if (method == 8)
+        return 1;
+#endif
+#ifdef ZIPRAND_HAVE_ZSTD
+    if (method == 93)
+        return 1;
+#endif
+    return 0;
+}
+
+static ziprand_error_t
+fopen_common(ziprand_archive_t* archive, const ziprand_entry_t* entry, ziprand_file_t* file)
 {
     if (!archive || !entry)
-        return NULL;
+        return ZIPRAND_ERR_INVALID_PARAM;
 
-    if (entry->compression_method != 0)
-        return NULL;
+    if (!method_supported(entry->compression_method))
+        return ZIPRAND_ERR_COMPRESSED;
+
+    /* the view array is contiguous, so the entry pointer recovers the
+     * column index */
+    size_t index = (size_t)(entry - archive->entries);
+    if (index >= archive->entry_count)
+        return ZIPRAND_ERR_INVALID_PARAM;
 
     /* calculate data offset if not already done */
-    ziprand_entry_t* mutable_entry = (ziprand_entry_t*)entry;
-    if (mutable_entry->data_offset == 0) {
-        if (get_data_offset(archive, mutable_entry) != ZIPRAND_OK)
-            return NULL;
+    if (archive->cols.data_offsets[index] == 0) {
+        ziprand_error_t err = get_data_offset(archive, index);
+        if (err != ZIPRAND_OK)
+            return err;
     }
+    /* sync the view so the read paths see the resolved offset; this is a
+     * same-value store when several threads open the entry concurrently */
+    ((ziprand_entry_t*)entry)->data_offset = archive->cols.data_offsets[index];
 
+    file->archive = archive;
+    file->entry = entry;
+    file->position = 0;
+    file->inflate = NULL;
+    file->zstd = NULL;
+    file->rbuf = NULL;
+    file->rbuf_cap = 0;
+    file->rbuf_off = 0;
+    file->rbuf_len = 0;
+    file->readahead = 0;
+
+#ifdef ZIPRAND_HAVE_ZLIB
+    if (entry->compression_method == 8) {
+        file->inflate = ziprand_inflate_new(archive, entry);
+        if (!file->inflate)
+            return ZIPRAND_ERR_NOMEM;
+    }
+#endif
+
+#ifdef ZIPRAND_HAVE_ZSTD
+    if (entry->compression_method == 93) {
+        /* requires the seekable format; a plain zstd stream has no frame
+         * index and would only allow whole-entry decompression */
+        file->zstd = ziprand_zstd_new(archive, entry);
+        if (!file->zstd)
+            return ZIPRAND_ERR_COMPRESSED;
+    }
+#endif
+
+    if (archive->verify) {
+        ziprand_error_t err = ziprand_fverify(file);
+        if (err != ZIPRAND_OK) {
+#ifdef ZIPRAND_HAVE_ZLIB
+            if (file->inflate)
+                ziprand_inflate_free(file->inflate);
+#endif
+#ifdef ZIPRAND_HAVE_ZSTD
+            if (file->zstd)
+                ziprand_zstd_free(file->zstd);
+#endif
+            return err;
+        }
+    }
+
+    return ZIPRAND_OK;
+}
+
+ziprand_file_t* ziprand_fopen(ziprand_archive_t* archive, const ziprand_entry_t* entry)
+{
     ziprand_file_t* file = malloc(sizeof(ziprand_file_t));
     if (!file)
         return NULL;
 
-    file->archive = archive;
-    file->entry = entry;
-    file->position = 0;
+    if (fopen_common(archive, entry, file) != ZIPRAND_OK) {
+        free(file);
+        return NULL;
+    }
+    file->owned = 1;
+    return file;
+}
+
+ziprand_file_t* ziprand_fopen_into(ziprand_archive_t* archive,
+                                   const ziprand_entry_t* entry,
+                                   ziprand_file_storage_t* storage)
+{
+    _Static_assert(sizeof(ziprand_file_storage_t) >= sizeof(ziprand_file_t),
+                   "ziprand_file_storage_t must hold the internal handle");
+    _Static_assert(_Alignof(ziprand_file_storage_t) >= _Alignof(ziprand_file_t),
+                   "ziprand_file_storage_t must be aligned for the internal handle");
 
+    if (!storage)
+        return NULL;
+
+    ziprand_file_t* file = (ziprand_file_t*)storage;
+    if (fopen_common(archive, entry, file) != ZIPRAND_OK)
+        return NULL;
+    file->owned = 0;
+    return file;
+}
+
+ziprand_file_t* ziprand_fopen_buffered(ziprand_archive_t* archive,
+                                       const ziprand_entry_t* entry,
+                                       size_t buffer_size)
+{
+    ziprand_file_t* file = ziprand_fopen(archive, entry);
+    if (!file)
+        return NULL;
+
+    size_t cap = buffer_size ? buffer_size : READAHEAD_DEFAULT_CAP;
+    file->rbuf = malloc(cap);
+    if (!file->rbuf) {
+        ziprand_fclose(file);
+        return NULL;
+    }
+    file->rbuf_cap = cap;
+    file->readahead = READAHEAD_INITIAL < cap ? READAHEAD_INITIAL : cap;
     return file;
 }
 
@@ -372,10 +1339,65 @@ ziprand_file_t* ziprand_fopen_by_name(ziprand_archive_t* archive, const char* na
     return ziprand_fopen(archive, entry);
 }
 
+/* serve a sequential read from the readahead buffer, refilling as needed */
+static int64_t fread_buffered(ziprand_file_t* file, void* buffer, size_t size)
+{
+    uint64_t entry_size = file->entry->uncompressed_size;
+    if (file->position >= entry_size)
+        return 0;
+    uint64_t remaining = entry_size - file->position;
+    if (size > remaining)
+        size = (size_t)remaining;
+
+    /* requests the buffer could not hold go straight to the backend */
+    if (size >= file->rbuf_cap) {
+        int64_t n = ziprand_fread_at(file, file->position, buffer, size);
+        if (n > 0)
+            file->position += n;
+        return n;
+    }
+
+    uint8_t* out = buffer;
+    size_t done = 0;
+    while (done < size) {
+        if (file->position >= file->rbuf_off &&
+            file->position < file->rbuf_off + file->rbuf_len) {
+            size_t at = (size_t)(file->position - file->rbuf_off);
+            size_t avail = file->rbuf_len - at;
+            size_t chunk = size - done < avail ? size - done : avail;
+            memcpy(out + done, file->rbuf + at, chunk);
+            done += chunk;
+            file->position += chunk;
+            continue;
+        }
+
+        /* refill: keep doubling the readahead while the consumer picks up
+         * exactly where the window ends; any jump resets it */
+        if (file->rbuf_len > 0) {
+            if (file->position == file->rbuf_off + file->rbuf_len) {
+                file->readahead *= 2;
+                if (file->readahead > file->rbuf_cap)
+                    file->readahead = file->rbuf_cap;
+            } else {
+                file->readahead =
+                    READAHEAD_INITIAL < file->rbuf_cap ? READAHEAD_INITIAL : file->rbuf_cap;
+            }
+        }
+        int64_t n = ziprand_fread_at(file, file->position, file->rbuf, file->readahead);
+        if (n <= 0)
+            return done > 0 ? (int64_t)done : n;
+        file->rbuf_off = file->position;
+        file->rbuf_len = (size_t)n;
+    }
+    return (int64_t)done;
+}
+
 int64_t ziprand_fread(ziprand_file_t* file, void* buffer, size_t size)
 {
-    if (!file)
+    if (!file || !buffer)
         return -1;
+    if (file->rbuf)
+        return fread_buffered(file, buffer, size);
     int64_t result = ziprand_fread_at(file, file->position, buffer, size);
     if (result > 0)
         file->position += result;
@@ -393,8 +1415,253 @@ int64_t ziprand_fread_at(ziprand_file_t* file, uint64_t offset, void* buffer, si
     uint64_t remaining = file->entry->uncompressed_size - offset;
     size_t to_read = size < remaining ? size : remaining;
 
-    return file->archive->io.read(
-        file->archive->io.ctx, file->entry->data_offset + offset, buffer, to_read);
+#ifdef ZIPRAND_HAVE_ZLIB
+    if (file->inflate)
+        return ziprand_inflate_read_at(file->inflate, offset, buffer, to_read);
+#endif
+
+#ifdef ZIPRAND_HAVE_ZSTD
+    if (file->zstd)
+        return ziprand_zstd_read_at(file->zstd, offset, buffer, to_read);
+#endif
+
+    return ziprand_archive_read(file->archive, file->entry->data_offset + offset, buffer, to_read);
+}
+
+/* effective readable size of a request, clamped to the entry */
+static size_t batch_req_size(const ziprand_file_t* file, const ziprand_read_req_t* req)
+{
+    if (req->offset >= file->entry->uncompressed_size)
+        return 0;
+    uint64_t remaining = file->entry->uncompressed_size - req->offset;
+    return req->size < remaining ? req->size : (size_t)remaining;
+}
+
+static int batch_req_cmp(const void* a, const void* b)
+{
+    const ziprand_read_req_t* ra = *(const ziprand_read_req_t* const*)a;
+    const ziprand_read_req_t* rb = *(const ziprand_read_req_t* const*)b;
+    if (ra->offset < rb->offset)
+        return -1;
+    if (ra->offset > rb->offset)
+        return 1;
+    return 0;
+}
+
+/* chunk size for full-entry verification passes */
+#define VERIFY_CHUNK (256u << 10)
+
+ziprand_error_t ziprand_fverify(ziprand_file_t* file)
+{
+    if (!file)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    uint64_t size = file->entry->uncompressed_size;
+    uint32_t crc = 0;
+
+    if (size > 0) {
+        uint8_t* buf = malloc(size < VERIFY_CHUNK ? (size_t)size : VERIFY_CHUNK);
+        if (!buf)
+            return ZIPRAND_ERR_NOMEM;
+
+        uint64_t offset = 0;
+        while (offset < size) {
+            size_t chunk = size - offset < VERIFY_CHUNK ? (size_t)(size - offset) : VERIFY_CHUNK;
+            if (ziprand_fread_at(file, offset, buf, chunk) != (int64_t)chunk) {
+                free(buf);
+                return ZIPRAND_ERR_IO;
+            }
+            crc = ziprand_crc32(crc, buf, chunk);
+            offset += chunk;
+        }
+        free(buf);
+    }
+
+    return crc == file->entry->crc32 ? ZIPRAND_OK : ZIPRAND_ERR_CRC;
+}
+
+void ziprand_get_stats(ziprand_archive_t* archive, ziprand_stats_t* out)
+{
+    if (!archive || !out)
+        return;
+
+    const ziprand_stats_atomic_t* stats = &archive->stats;
+    out->reads = atomic_load_explicit(&stats->reads, memory_order_relaxed);
+    out->bytes_read = atomic_load_explicit(&stats->bytes_read, memory_order_relaxed);
+    for (size_t i = 0; i < ZIPRAND_STATS_BUCKETS; i++)
+        out->reads_by_bucket[i] =
+            atomic_load_explicit(&stats->reads_by_bucket[i], memory_order_relaxed);
+    out->lookups = atomic_load_explicit(&stats->lookups, memory_order_relaxed);
+    out->lookups_found = atomic_load_explicit(&stats->lookups_found, memory_order_relaxed);
+    out->cd_parse_ns = atomic_load_explicit(&stats->cd_parse_ns, memory_order_relaxed);
+    out->eocd_scan_bytes = atomic_load_explicit(&stats->eocd_scan_bytes, memory_order_relaxed);
+}
+
+void ziprand_set_trace(ziprand_archive_t* archive, ziprand_trace_fn fn, void* user)
+{
+    if (!archive)
+        return;
+    archive->trace_user = user;
+    archive->trace = fn;
+}
+
+int64_t ziprand_fread_batch(ziprand_file_t* file, ziprand_read_req_t* reqs, size_t count)
+{
+    if (!file || (!reqs && count > 0))
+        return -1;
+    if (count == 0)
+        return 0;
+
+#if defined(ZIPRAND_HAVE_ZLIB) || defined(ZIPRAND_HAVE_ZSTD)
+    int compressed = 0;
+#ifdef ZIPRAND_HAVE_ZLIB
+    compressed |= file->inflate != NULL;
+#endif
+#ifdef ZIPRAND_HAVE_ZSTD
+    compressed |= file->zstd != NULL;
+#endif
+    if (compressed) {
+        /* compressed entries gain nothing from reordering the backend I/O;
+         * serve each request through the decompression path */
+        int64_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            reqs[i].result = ziprand_fread_at(file, reqs[i].offset, reqs[i].buffer, reqs[i].size);
+            if (reqs[i].result > 0)
+                total += reqs[i].result;
+        }
+        return total;
+    }
+#endif
+
+    ziprand_read_req_t** order = malloc(count * sizeof(*order));
+    if (!order)
+        return -1;
+    for (size_t i = 0; i < count; i++)
+        order[i] = &reqs[i];
+    qsort(order, count, sizeof(*order), batch_req_cmp);
+
+    int64_t total = 0;
+    size_t i = 0;
+    while (i < count) {
+        size_t first_size = batch_req_size(file, order[i]);
+        if (first_size == 0) {
+            order[i]->result = 0;
+            i++;
+            continue;
+        }
+
+        /* extend the run while requests are contiguous in the file */
+        size_t run = 1;
+        uint64_t end = order[i]->offset + first_size;
+        while (file->archive->io.readv && i + run < count && order[i + run]->offset == end) {
+            size_t req_size = batch_req_size(file, order[i + run]);
+            if (req_size != order[i + run]->size)
+                break; /* clamped request cannot stay contiguous */
+            end += req_size;
+            run++;
+        }
+
+        if (run > 1) {
+            ziprand_iovec_t* iov = malloc(run * sizeof(*iov));
+            if (!iov) {
+                free(order);
+                return -1;
+            }
+            for (size_t j = 0; j < run; j++) {
+                iov[j].buffer = order[i + j]->buffer;
+                iov[j].size = j == 0 ? first_size : order[i + j]->size;
+            }
+
+            int64_t got = file->archive->io.readv(file->archive->io.ctx,
+                                                  file->entry->data_offset + order[i]->offset,
+                                                  iov,
+                                                  run);
+            /* distribute the contiguous byte count across the run */
+            for (size_t j = 0; j < run; j++) {
+                if (got < 0) {
+                    order[i + j]->result = -1;
+                } else {
+                    int64_t take = (int64_t)iov[j].size < got ? (int64_t)iov[j].size : got;
+                    order[i + j]->result = take;
+                    got -= take;
+                    total += take;
+                }
+            }
+            free(iov);
+        } else {
+            int64_t got = ziprand_archive_read(file->archive,
+                                               file->entry->data_offset + order[i]->offset,
+                                               order[i]->buffer,
+                                               first_size);
+            order[i]->result = got;
+            if (got > 0)
+                total += got;
+        }
+
+        i += run;
+    }
+
+    free(order);
+    return total;
+}
+
+int ziprand_fread_async(ziprand_file_t* file,
+                        uint64_t offset,
+                        void* buffer,
+                        size_t size,
+                        ziprand_read_cb cb,
+                        void* user)
+{
+    if (!file || !buffer || !cb)
+        return -1;
+
+    if (!file->archive->io.submit)
+        return -1;
+
+    if (file->entry->compression_method != 0)
+        return -1; /* async reads serve stored entries only */
+
+    if (offset >= file->entry->uncompressed_size) {
+        cb(user, 0);
+        return 0;
+    }
+
+    uint64_t remaining = file->entry->uncompressed_size - offset;
+    size_t to_read = size < remaining ? size : remaining;
+
+    return file->archive->io.submit(
+        file->archive->io.ctx, file->entry->data_offset + offset, buffer, to_read, cb, user);
+}
+
+int ziprand_reap(ziprand_archive_t* archive, int min_completions)
+{
+    if (!archive || !archive->io.reap)
+        return -1;
+    return archive->io.reap(archive->io.ctx, min_completions);
+}
+
+ziprand_error_t
+ziprand_fmap(ziprand_file_t* file, uint64_t offset, size_t size, const void** ptr)
+{
+    if (!file || !ptr)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    if (!file->archive->io.map)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    if (file->entry->compression_method != 0)
+        return ZIPRAND_ERR_COMPRESSED;
+
+    if (offset + size > file->entry->uncompressed_size)
+        return ZIPRAND_ERR_SEEK_BEYOND_END;
+
+    const void* mapped =
+        file->archive->io.map(file->archive->io.ctx, file->entry->data_offset + offset, size);
+    if (!mapped)
+        return ZIPRAND_ERR_IO;
+
+    *ptr = mapped;
+    return ZIPRAND_OK;
 }
 
 int64_t ziprand_fseek(ziprand_file_t* file, int64_t offset, int whence)
@@ -448,9 +1715,136 @@ int64_t ziprand_fsize(ziprand_file_t* file)
     return file ? (int64_t)file->entry->uncompressed_size : -1;
 }
 
+ziprand_error_t
+ziprand_fadvise(ziprand_file_t* file, uint64_t offset, uint64_t size, ziprand_advise_t hint)
+{
+    if (!file)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    ziprand_archive_t* archive = file->archive;
+    if (!archive->io.advise)
+        return ZIPRAND_OK; /* hints are best-effort; no backend support is fine */
+
+    uint64_t base;
+    uint64_t span;
+    if (file->entry->compression_method == 0) {
+        if (offset > file->entry->uncompressed_size)
+            return ZIPRAND_ERR_INVALID_PARAM;
+        uint64_t remaining = file->entry->uncompressed_size - offset;
+        base = file->entry->data_offset + offset;
+        span = (size == 0 || size > remaining) ? remaining : size;
+    } else {
+        /* entry offsets do not map to source offsets through compression;
+         * hint the whole compressed payload instead */
+        base = file->entry->data_offset;
+        span = file->entry->compressed_size;
+    }
+
+    return archive->io.advise(archive->io.ctx, base, span, hint) == 0 ? ZIPRAND_OK
+                                                                      : ZIPRAND_ERR_IO;
+}
+
+/* I/O view over a stored entry's byte range (nested archives) */
+typedef struct {
+    ziprand_archive_t* archive;
+    uint64_t base; /* absolute offset of the entry's data */
+    uint64_t size;
+} subrange_io_ctx_t;
+
+static int64_t subrange_read(void* ctx, uint64_t offset, void* buffer, size_t size)
+{
+    subrange_io_ctx_t* sctx = ctx;
+
+    if (offset >= sctx->size)
+        return 0;
+    if (size > sctx->size - offset)
+        size = (size_t)(sctx->size - offset);
+    return ziprand_archive_read(sctx->archive, sctx->base + offset, buffer, size);
+}
+
+static int64_t subrange_size(void* ctx)
+{
+    return (int64_t)((subrange_io_ctx_t*)ctx)->size;
+}
+
+static const void* subrange_map(void* ctx, uint64_t offset, size_t size)
+{
+    subrange_io_ctx_t* sctx = ctx;
+
+    if (!sctx->archive->io.map)
+        return NULL;
+    if (offset > sctx->size || size > sctx->size - offset)
+        return NULL;
+    return sctx->archive->io.map(sctx->archive->io.ctx, sctx->base + offset, size);
+}
+
+/* forward hints to the parent backend with offsets translated */
+static int subrange_advise(void* ctx, uint64_t offset, uint64_t size, ziprand_advise_t hint)
+{
+    subrange_io_ctx_t* sctx = ctx;
+
+    if (!sctx->archive->io.advise)
+        return 0;
+    if (offset > sctx->size)
+        return -1;
+    if (size == 0 || size > sctx->size - offset)
+        size = sctx->size - offset;
+    return sctx->archive->io.advise(sctx->archive->io.ctx, sctx->base + offset, size, hint);
+}
+
+static void subrange_close(void* ctx)
+{
+    free(ctx);
+}
+
+ziprand_io_t* ziprand_io_subrange(ziprand_file_t* file)
+{
+    /* only stored entries are a contiguous byte range of the parent */
+    if (!file || file->entry->compression_method != 0)
+        return NULL;
+
+    subrange_io_ctx_t* sctx = malloc(sizeof(subrange_io_ctx_t));
+    if (!sctx)
+        return NULL;
+
+    sctx->archive = file->archive;
+    sctx->base = file->entry->data_offset;
+    sctx->size = file->entry->uncompressed_size;
+
+    ziprand_io_t* io = malloc(sizeof(ziprand_io_t));
+    if (!io) {
+        free(sctx);
+        return NULL;
+    }
+
+    io->ctx = sctx;
+    io->read = subrange_read;
+    io->get_size = subrange_size;
+    io->close = subrange_close;
+    io->map = subrange_map;
+    io->readv = NULL;
+    io->submit = NULL;
+    io->reap = NULL;
+    io->advise = subrange_advise;
+
+    return io;
+}
+
 void ziprand_fclose(ziprand_file_t* file)
 {
-    free(file);
+    if (!file)
+        return;
+#ifdef ZIPRAND_HAVE_ZLIB
+    if (file->inflate)
+        ziprand_inflate_free(file->inflate);
+#endif
+#ifdef ZIPRAND_HAVE_ZSTD
+    if (file->zstd)
+        ziprand_zstd_free(file->zstd);
+#endif
+    free(file->rbuf);
+    if (file->owned)
+        free(file);
 }
 
 const char* ziprand_strerror(ziprand_error_t error)
@@ -472,6 +1866,8 @@ const char* ziprand_strerror(ziprand_error_t error)
         return "Invalid parameter";
     case ZIPRAND_ERR_SEEK_BEYOND_END:
         return "Seek beyond end of file";
+    case ZIPRAND_ERR_CRC:
+        return "CRC-32 mismatch";
     default:
         return "Unknown error";
     }
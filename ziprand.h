@@ -17,7 +17,8 @@ typedef enum {
     ZIPRAND_ERR_COMPRESSED = -4,
     ZIPRAND_ERR_NOMEM = -5,
     ZIPRAND_ERR_INVALID_PARAM = -6,
-    ZIPRAND_ERR_SEEK_BEYOND_END = -7
+    ZIPRAND_ERR_SEEK_BEYOND_END = -7,
+    ZIPRAND_ERR_CRC = -8
 } ziprand_error_t;
 
 /* I/O callback function types */
@@ -46,12 +47,103 @@ typedef int64_t (*ziprand_size_fn)(void* io_ctx);
  */
 typedef void (*ziprand_close_fn)(void* io_ctx);
 
+/**
+ * Optional zero-copy map callback - returns a direct pointer to a range
+ * of the source, valid until the I/O interface is closed
+ * @param io_ctx User-provided context
+ * @param offset Absolute offset of the range
+ * @param size Size of the range in bytes
+ * @return Pointer to the range, or NULL if it cannot be mapped
+ */
+typedef const void* (*ziprand_map_fn)(void* io_ctx, uint64_t offset, size_t size);
+
+/* Buffer descriptor for vectored reads */
+typedef struct {
+    void* buffer; /* Destination buffer */
+    size_t size;  /* Buffer size in bytes */
+} ziprand_iovec_t;
+
+/**
+ * Optional vectored read callback - reads one contiguous source range into
+ * multiple buffers (preadv semantics)
+ * @param io_ctx User-provided context
+ * @param offset Absolute offset to read from
+ * @param iov Destination buffers, filled in order
+ * @param iov_count Number of buffers
+ * @return Total number of bytes read, or -1 on error
+ */
+typedef int64_t (*ziprand_readv_fn)(void* io_ctx,
+                                    uint64_t offset,
+                                    const ziprand_iovec_t* iov,
+                                    size_t iov_count);
+
+/**
+ * Completion callback for asynchronous reads
+ * @param user User pointer passed at submission
+ * @param result Number of bytes read, or -1 on error
+ */
+typedef void (*ziprand_read_cb)(void* user, int64_t result);
+
+/**
+ * Optional asynchronous read submission callback - queues a read without
+ * blocking; the completion callback fires from a later reap call
+ * @param io_ctx User-provided context
+ * @param offset Absolute offset to read from
+ * @param buffer Buffer to read into (must stay valid until completion)
+ * @param size Number of bytes to read
+ * @param cb Completion callback
+ * @param user User pointer for the callback
+ * @return 0 on successful submission, -1 on error
+ */
+typedef int (*ziprand_submit_fn)(void* io_ctx,
+                                 uint64_t offset,
+                                 void* buffer,
+                                 size_t size,
+                                 ziprand_read_cb cb,
+                                 void* user);
+
+/* Access-pattern hints for ziprand_fadvise and the advise callback */
+typedef enum {
+    ZIPRAND_ADVISE_WILLNEED = 0,   /* prefetch: the range is about to be read */
+    ZIPRAND_ADVISE_DONTNEED = 1,   /* evict: the range will not be read again */
+    ZIPRAND_ADVISE_SEQUENTIAL = 2, /* the range will be read front to back */
+    ZIPRAND_ADVISE_RANDOM = 3      /* the range will be read in random order */
+} ziprand_advise_t;
+
+/**
+ * Optional paging-hint callback - forwards an access-pattern hint for a
+ * source byte range to the OS (posix_fadvise, madvise, ...)
+ * @param io_ctx User-provided context
+ * @param offset Absolute offset of the range
+ * @param size Size of the range in bytes, 0 for everything to the end
+ * @param hint Access-pattern hint
+ * @return 0 on success, -1 on error
+ */
+typedef int (*ziprand_advise_fn)(void* io_ctx,
+                                 uint64_t offset,
+                                 uint64_t size,
+                                 ziprand_advise_t hint);
+
+/**
+ * Optional completion reap callback - waits for at least min_completions
+ * outstanding reads (0 to poll) and invokes their completion callbacks
+ * @param io_ctx User-provided context
+ * @param min_completions Minimum completions to wait for
+ * @return Number of completions processed, or -1 on error
+ */
+typedef int (*ziprand_reap_fn)(void* io_ctx, int min_completions);
+
 /* I/O interface structure */
 struct ziprand_io {
-    void* ctx;                /* User-provided context pointer */
-    ziprand_read_fn read;     /* Read function */
-    ziprand_size_fn get_size; /* Get size function */
-    ziprand_close_fn close;   /* Optional close function (can be NULL) */
+    void* ctx;                 /* User-provided context pointer */
+    ziprand_read_fn read;      /* Read function */
+    ziprand_size_fn get_size;  /* Get size function */
+    ziprand_close_fn close;    /* Optional close function (can be NULL) */
+    ziprand_map_fn map;        /* Optional zero-copy map function (can be NULL) */
+    ziprand_readv_fn readv;    /* Optional vectored read function (can be NULL) */
+    ziprand_submit_fn submit;  /* Optional async read submission (can be NULL) */
+    ziprand_reap_fn reap;      /* Optional async completion reap (can be NULL) */
+    ziprand_advise_fn advise;  /* Optional paging-hint function (can be NULL) */
 };
 
 /* ZIP entry information */
@@ -62,6 +154,7 @@ typedef struct {
     uint64_t offset;             /* Offset of local header */
     uint64_t data_offset;        /* Offset of actual data */
     uint16_t compression_method; /* 0 = stored, 8 = deflate, etc. */
+    uint32_t crc32;              /* CRC-32 of the uncompressed data */
 } ziprand_entry_t;
 
 /* Main ZIP archive handle */
@@ -77,6 +170,108 @@ typedef struct ziprand_file ziprand_file_t;
  */
 ziprand_archive_t* ziprand_open(const ziprand_io_t* io);
 
+/* Options for ziprand_open_ex; zero-initialize for defaults */
+typedef struct {
+    int lazy;                /* Non-zero: parse the central directory incrementally */
+    int threads;             /* Worker threads for CD parsing: 0 = auto (one per
+                                core), 1 = serial, N = use up to N threads */
+    size_t cache_block_size; /* Cache block size, rounded up to a power of two
+                                (0 = 64 KiB when the cache is enabled) */
+    size_t cache_blocks;     /* Number of cache blocks (0 disables the cache) */
+    int verify;              /* Non-zero: ziprand_fopen verifies each entry's
+                                CRC-32 before returning a handle */
+} ziprand_open_opts_t;
+
+/**
+ * Open a ZIP archive with options. A non-zero cache_blocks attaches a
+ * fixed-capacity block cache between the archive and its I/O backend:
+ * small reads (entry data and central directory alike) are served from
+ * power-of-two aligned cached blocks with LRU eviction, and cache hits
+ * only take a shared lock so concurrent readers do not serialize.
+ * @param io I/O interface (copied internally)
+ * @param opts Options (NULL behaves like ziprand_open)
+ * @return Archive handle or NULL on error
+ */
+ziprand_archive_t* ziprand_open_ex(const ziprand_io_t* io, const ziprand_open_opts_t* opts);
+
+/**
+ * Open an archive through the process-level handle cache. Archives are
+ * keyed on (path, size, mtime): the first opener parses the central
+ * directory and resolves all data offsets, and every later opener of
+ * the same unchanged file shares that archive for the cost of a stat
+ * and a refcount bump. ziprand_close drops one reference; the last one
+ * tears the archive down. The shared entry table is immutable, so
+ * concurrent readers need no locking. If the file changes on disk, new
+ * opens parse it afresh while existing holders keep the old snapshot.
+ * @param path Archive file path
+ * @return Shared archive handle or NULL on error
+ */
+ziprand_archive_t* ziprand_open_cached(const char* path);
+
+/**
+ * Open a ZIP archive lazily: only the End of Central Directory is located
+ * up front, and central directory records are parsed incrementally as
+ * lookups and index accesses need them. Startup cost is proportional to
+ * entries actually touched rather than archive size.
+ * @param io I/O interface (copied internally)
+ * @return Archive handle or NULL on error
+ */
+ziprand_archive_t* ziprand_open_lazy(const ziprand_io_t* io);
+
+/**
+ * Rebuild the entry table of a damaged archive by sweeping the whole
+ * file for local file headers, ignoring the (possibly missing or
+ * corrupt) EOCD and central directory. The sweep is chunked and runs
+ * across threads, so recovery cost is streaming-read bandwidth. Sizes
+ * and CRCs come from the local headers; entries written with a data
+ * descriptor (flag bit 3) are recovered with zero sizes and cannot be
+ * read back, but their names and offsets are preserved. Intended as a
+ * fallback when ziprand_open returns NULL.
+ * @param io I/O interface (copied internally; must be safe for
+ *           concurrent reads, like the file backend)
+ * @return Recovered archive handle or NULL if nothing was salvageable
+ */
+ziprand_archive_t* ziprand_open_recover(const ziprand_io_t* io);
+
+/**
+ * Serialize the parsed entry table (including resolved data offsets and
+ * the name-lookup index) into a compact flat sidecar file for instant
+ * reopen via ziprand_open_with_index(). A lazy archive is fully
+ * materialized first.
+ * @param archive Archive handle
+ * @param path Sidecar file path
+ * @return ZIPRAND_OK or an error code
+ */
+ziprand_error_t ziprand_index_save(ziprand_archive_t* archive, const char* path);
+
+/**
+ * Open a ZIP archive from a sidecar index written by ziprand_index_save(),
+ * skipping the central directory parse. The sidecar is validated against
+ * the archive by size and central-directory fingerprint; on mismatch (or
+ * any other failure) NULL is returned and the caller should fall back to
+ * ziprand_open().
+ * @param io I/O interface (copied internally)
+ * @param index_path Sidecar file path
+ * @return Archive handle or NULL on error
+ */
+ziprand_archive_t* ziprand_open_with_index(const ziprand_io_t* io, const char* index_path);
+
+/**
+ * Resolve the data offset of every entry up front.
+ *
+ * ziprand_fopen() normally computes an entry's data offset on first open
+ * with one local-header read, mutating the entry in place; that lazy
+ * initialization is not safe when two threads open the same entry
+ * concurrently. This pass sorts entries by offset, reads local headers in
+ * large coalesced slabs and fills every data_offset eagerly, after which
+ * ziprand_fopen() never writes to the entry table and is fully
+ * thread-safe. A lazy archive is fully materialized first.
+ *
+ * @param archive Archive handle
+ * @return ZIPRAND_OK on success
+ */
+ziprand_error_t ziprand_resolve_offsets(ziprand_archive_t* archive);
+
 /**
  * Close the archive and free all resources
  * @param archive Archive handle
@@ -107,13 +302,198 @@ const ziprand_entry_t* ziprand_get_entry_by_index(ziprand_archive_t* archive, si
 const ziprand_entry_t* ziprand_find_entry(ziprand_archive_t* archive, const char* name);
 
 /**
- * Open a file within the archive for reading (only uncompressed files supported)
+ * Resolve a batch of names in one pass over the hash index. Lookups are
+ * software-pipelined - each group of names is hashed and its table slots
+ * prefetched before any probe runs - so bulk resolution overlaps cache
+ * misses instead of serializing them the way per-name ziprand_find_entry
+ * calls do. Results are positional: out[i] receives the entry for
+ * names[i], or NULL if that name (or a NULL pointer) is not present.
+ * @param archive Archive handle
+ * @param names Array of entry names to resolve
+ * @param count Number of names (and capacity of out)
+ * @param out Filled with one entry pointer per name (owned by archive)
+ * @return ZIPRAND_OK on success (individual misses are not an error)
+ */
+ziprand_error_t ziprand_find_entries(ziprand_archive_t* archive,
+                                     const char* const* names,
+                                     size_t count,
+                                     const ziprand_entry_t** out);
+
+/* Read-only columnar view of the entry table. Each array has one element
+ * per entry in CD order; scanning a single column touches only that
+ * field's bytes instead of striding whole ziprand_entry_t structs, which
+ * matters for full-archive scans over millions of entries. */
+typedef struct {
+    const char* const* names;           /* NUL-terminated entry names */
+    const uint64_t* compressed_sizes;
+    const uint64_t* uncompressed_sizes;
+    const uint64_t* offsets;            /* local header offsets */
+    const uint16_t* compression_methods;
+    const uint32_t* crc32s;
+    size_t count;
+} ziprand_entry_columns_t;
+
+/**
+ * Get the columnar view of the entry table for bulk iteration.
+ *
+ * A lazy archive is fully materialized first. The returned pointers are
+ * owned by the archive and stay valid until ziprand_close(); they never
+ * move once handed out.
+ *
+ * @param archive Archive handle
+ * @param out Filled with the column pointers and entry count
+ * @return ZIPRAND_OK on success
+ */
+ziprand_error_t ziprand_get_columns(ziprand_archive_t* archive, ziprand_entry_columns_t* out);
+
+/* Per-entry callback for ziprand_list_prefix() and ziprand_enumerate();
+ * return nonzero to stop the listing early. */
+typedef int (*ziprand_list_fn)(const ziprand_entry_t* entry, void* user);
+
+/**
+ * List all entries whose name starts with prefix, in sorted name order.
+ *
+ * A secondary index sorted by name is built on the first call (fully
+ * materializing a lazy archive) and reused afterwards, so queries cost
+ * O(log n + results) instead of a scan over every entry. An empty prefix
+ * lists the whole archive.
+ *
+ * @param archive Archive handle
+ * @param prefix Name prefix to match
+ * @param callback Invoked once per matching entry
+ * @param user Opaque pointer passed through to the callback
+ * @return Number of matching entries visited (including the one that
+ *         stopped the listing), or -1 on error
+ */
+int64_t ziprand_list_prefix(ziprand_archive_t* archive,
+                            const char* prefix,
+                            ziprand_list_fn callback,
+                            void* user);
+
+/**
+ * Stream every central-directory record to a callback without building
+ * an archive handle. Records are parsed straight out of a sliding read
+ * window and the callback sees a transient ziprand_entry_t view - the
+ * entry (including its name) is only valid for the duration of the
+ * call. Memory use is constant regardless of entry count, so listing a
+ * multi-million-entry archive costs no more RSS than a small one.
+ * data_offset is zero; open the archive to read entry contents.
+ *
+ * @param io I/O interface to read the archive from
+ * @param callback Invoked once per entry, in central-directory order
+ * @param user Opaque pointer passed through to the callback
+ * @return Number of entries visited (including the one that stopped the
+ *         enumeration), or -1 on error
+ */
+int64_t ziprand_enumerate(const ziprand_io_t* io, ziprand_list_fn callback, void* user);
+
+/**
+ * Open a file within the archive for reading. Stored (method 0) entries
+ * are always supported; DEFLATE (method 8) entries require a build with
+ * the zlib option and seekable-zstd (method 93) entries a build with the
+ * zstd option. Entries using any other compression method are rejected.
  * @param archive Archive handle
  * @param entry Entry to open
- * @return File handle or NULL on error
+ * @return File handle or NULL on error (including unsupported methods)
  */
 ziprand_file_t* ziprand_fopen(ziprand_archive_t* archive, const ziprand_entry_t* entry);
 
+/* Caller-provided storage for a file handle opened with
+ * ziprand_fopen_into(). Sized and aligned to hold the internal handle;
+ * the contents are private and must not be inspected or moved while the
+ * handle is open. */
+typedef struct {
+    void* opaque[11];
+} ziprand_file_storage_t;
+
+/**
+ * Open a file into caller-provided storage instead of the heap.
+ *
+ * Identical to ziprand_fopen() except the handle lives in *storage, so
+ * the open/close pair performs no heap allocation for stored entries
+ * (DEFLATE entries still allocate their decompression state). The
+ * returned handle must still be passed to ziprand_fclose(), which
+ * releases internal resources but leaves the storage to the caller.
+ *
+ * @param archive Archive handle
+ * @param entry Entry to open
+ * @param storage Backing memory for the handle; must outlive it
+ * @return File handle (aliasing storage) or NULL on error
+ */
+ziprand_file_t* ziprand_fopen_into(ziprand_archive_t* archive,
+                                   const ziprand_entry_t* entry,
+                                   ziprand_file_storage_t* storage);
+
+/**
+ * Open a file with a readahead buffer for sequential consumption.
+ *
+ * Identical to ziprand_fopen() except ziprand_fread() is served from a
+ * readahead buffer: the handle reads ahead in large blocks and grows the
+ * readahead while the access pattern stays sequential, so parsers pulling
+ * a few bytes per call cost one backend read per buffer fill instead of
+ * one per call. Reads at or above the buffer size, and all
+ * ziprand_fread_at() calls, bypass the buffer. A seek to a position
+ * outside the buffered window resets the readahead to its initial size.
+ *
+ * @param archive Archive handle
+ * @param entry Entry to open
+ * @param buffer_size Readahead buffer capacity in bytes, 0 for the default (256 KiB)
+ * @return File handle or NULL on error
+ */
+ziprand_file_t* ziprand_fopen_buffered(ziprand_archive_t* archive,
+                                       const ziprand_entry_t* entry,
+                                       size_t buffer_size);
+
+/* Number of read-size histogram buckets in ziprand_stats_t: powers of
+ * four from <=1 KiB up, with the last bucket catching everything larger */
+#define ZIPRAND_STATS_BUCKETS 8
+
+/* Snapshot of per-archive I/O statistics; counters are maintained with
+ * relaxed atomics, so the snapshot is cheap but not a consistent cut
+ * across fields under concurrent activity. */
+typedef struct {
+    uint64_t reads;      /* archive-level reads issued */
+    uint64_t bytes_read; /* bytes successfully read */
+    uint64_t reads_by_bucket[ZIPRAND_STATS_BUCKETS]; /* reads by request size:
+                            <=1K, <=4K, <=16K, <=64K, <=256K, <=1M, <=4M, >4M */
+    uint64_t lookups;         /* ziprand_find_entry calls */
+    uint64_t lookups_found;   /* lookups that returned an entry */
+    uint64_t cd_parse_ns;     /* time spent parsing central-directory records */
+    uint64_t eocd_scan_bytes; /* trailing bytes scanned to locate the EOCD */
+} ziprand_stats_t;
+
+/**
+ * Snapshot the archive's I/O statistics into *out.
+ * @param archive Archive handle
+ * @param out Filled with the current counter values
+ */
+void ziprand_get_stats(ziprand_archive_t* archive, ziprand_stats_t* out);
+
+/* Trace callback for individual archive-level reads; result is the byte
+ * count returned by the backend, or a negative error. Fires on the read
+ * path, so keep it cheap and thread-safe. */
+typedef void (*ziprand_trace_fn)(void* user, uint64_t offset, size_t size, int64_t result);
+
+/**
+ * Install (or clear, with fn = NULL) a per-read trace hook.
+ * @param archive Archive handle
+ * @param fn Trace callback, or NULL to disable tracing
+ * @param user Opaque pointer passed through to the callback
+ */
+void ziprand_set_trace(ziprand_archive_t* archive, ziprand_trace_fn fn, void* user);
+
+/**
+ * Verify the file's content against the CRC-32 recorded in the central
+ * directory. Reads the whole entry (decompressing DEFLATE entries), so
+ * the cost is one full pass over the data; the checksum itself runs on
+ * hardware CRC instructions where available.
+ *
+ * @param file File handle
+ * @return ZIPRAND_OK if the checksum matches, ZIPRAND_ERR_CRC on
+ *         mismatch, or another error code if reading fails
+ */
+ziprand_error_t ziprand_fverify(ziprand_file_t* file);
+
 /**
  * Open a file by name
  * @param archive Archive handle
@@ -141,6 +521,111 @@ int64_t ziprand_fread(ziprand_file_t* file, void* buffer, size_t size);
  */
 int64_t ziprand_fread_at(ziprand_file_t* file, uint64_t offset, void* buffer, size_t size);
 
+/* One request in a batched read */
+typedef struct {
+    uint64_t offset; /* Offset within the file */
+    void* buffer;    /* Destination buffer */
+    size_t size;     /* Number of bytes to read */
+    int64_t result;  /* Filled by ziprand_fread_batch: bytes read or -1 */
+} ziprand_read_req_t;
+
+/**
+ * Read a batch of scattered ranges from a file. Requests are sorted by
+ * offset and adjacent ranges are dispatched through the backend's vectored
+ * read callback when it provides one, amortizing callback and syscall
+ * overhead across the batch. Per-request byte counts are stored in each
+ * request's result field.
+ * @param file File handle
+ * @param reqs Array of read requests
+ * @param count Number of requests
+ * @return Total bytes read across the batch, or -1 on error
+ */
+int64_t ziprand_fread_batch(ziprand_file_t* file, ziprand_read_req_t* reqs, size_t count);
+
+/* Options for ziprand_extract_batch; zero-initialize for defaults */
+typedef struct {
+    int threads; /* worker threads: 0 = auto (one per core), N = up to N */
+} ziprand_extract_opts_t;
+
+/**
+ * Extract a set of entries under a destination directory using a worker
+ * pool. Entries are processed in ascending data-offset order so the
+ * source archive is read roughly sequentially, and each worker streams
+ * through its own chunk buffer so source reads overlap destination
+ * writes. Parent directories are created as needed; entry names with an
+ * absolute path or a ".." component are rejected. The first error stops
+ * new work from being claimed and is returned once in-flight entries
+ * finish, which may leave some entries unextracted or truncated.
+ * @param archive Archive handle
+ * @param entries Entries to extract
+ * @param count Number of entries
+ * @param dest_dir Destination directory (must exist)
+ * @param opts Options (NULL for defaults)
+ * @return ZIPRAND_OK or the first error encountered
+ */
+ziprand_error_t ziprand_extract_batch(ziprand_archive_t* archive,
+                                      const ziprand_entry_t* const* entries,
+                                      size_t count,
+                                      const char* dest_dir,
+                                      const ziprand_extract_opts_t* opts);
+
+/**
+ * Submit an asynchronous read from a stored entry (random access). Only
+ * available when the backend provides a submit callback (the io_uring
+ * backend does). The completion callback fires from ziprand_reap().
+ * @param file File handle
+ * @param offset Offset within the file
+ * @param buffer Buffer to read into (must stay valid until completion)
+ * @param size Number of bytes to read
+ * @param cb Completion callback
+ * @param user User pointer for the callback
+ * @return 0 on successful submission, -1 on error
+ */
+int ziprand_fread_async(ziprand_file_t* file,
+                        uint64_t offset,
+                        void* buffer,
+                        size_t size,
+                        ziprand_read_cb cb,
+                        void* user);
+
+/**
+ * Wait for and dispatch asynchronous read completions on this archive
+ * @param archive Archive handle
+ * @param min_completions Minimum completions to wait for (0 to poll)
+ * @return Number of completions processed, or -1 on error
+ */
+int ziprand_reap(ziprand_archive_t* archive, int min_completions);
+
+/**
+ * Get a zero-copy pointer to a range of a stored entry (random access).
+ * Only available when the backend provides a map callback (memory and
+ * mmap backends do); the pointer stays valid until ziprand_close().
+ * @param file File handle
+ * @param offset Offset within the file
+ * @param size Number of bytes to map
+ * @param ptr Receives the pointer on success
+ * @return ZIPRAND_OK, ZIPRAND_ERR_INVALID_PARAM if the backend cannot map,
+ *         ZIPRAND_ERR_SEEK_BEYOND_END if the range exceeds the entry
+ */
+ziprand_error_t
+ziprand_fmap(ziprand_file_t* file, uint64_t offset, size_t size, const void** ptr);
+
+/**
+ * Pass an access-pattern hint for a range of the entry to the OS, so
+ * applications can prefetch entries they are about to serve (WILLNEED)
+ * or evict one-shot data from page cache (DONTNEED). The range is
+ * translated to the underlying source bytes; for compressed entries the
+ * hint covers the entry's whole compressed payload. A no-op when the
+ * I/O backend has no advise callback.
+ * @param file File handle
+ * @param offset Offset within the entry
+ * @param size Number of bytes, 0 for everything to the end of the entry
+ * @param hint Access-pattern hint
+ * @return ZIPRAND_OK (including when unsupported), or an error code
+ */
+ziprand_error_t
+ziprand_fadvise(ziprand_file_t* file, uint64_t offset, uint64_t size, ziprand_advise_t hint);
+
 /**
  * Seek to position in file
  * @param file File handle
@@ -185,6 +670,55 @@ const char* ziprand_strerror(ziprand_error_t error);
  */
 ziprand_io_t* ziprand_io_file(const char* path);
 
+/**
+ * Create I/O interface backed by io_uring; synchronous reads run through
+ * the ring, and the submit/reap callbacks let a single thread keep many
+ * reads in flight via ziprand_fread_async(). One interface must only be
+ * driven from one thread at a time.
+ * @param path File path
+ * @return Allocated I/O interface (must be freed with ziprand_io_free),
+ *         or NULL when built without liburing support
+ */
+ziprand_io_t* ziprand_io_uring(const char* path);
+
+/**
+ * Create I/O interface that memory-maps a file; reads and ziprand_fmap()
+ * are served straight from the page cache with no copies through read()
+ * @param path File path
+ * @return Allocated I/O interface (must be freed with ziprand_io_free)
+ */
+ziprand_io_t* ziprand_io_mmap(const char* path);
+
+/**
+ * Create I/O interface for an archive served over HTTP(S) using Range
+ * requests. A persistent connection is reused across requests; the
+ * archive tail (EOCD and central directory) is cached from one suffix
+ * Range fetch, so opening a remote archive costs a single round trip,
+ * and small reads elsewhere are coalesced into larger windows. Drive
+ * one interface from one thread at a time. The server must support
+ * Range requests.
+ * @param url Archive URL
+ * @return Allocated I/O interface (must be freed with ziprand_io_free),
+ *         or NULL when built without libcurl support
+ */
+ziprand_io_t* ziprand_io_http(const char* url);
+
+/**
+ * Create a cache-bypassing file I/O interface for bulk cold scans.
+ * Reads of 256 KiB and up are issued O_DIRECT so multi-GB sweeps stream
+ * at device bandwidth without evicting the page cache other readers
+ * depend on; smaller reads (metadata, local headers) use a regular
+ * descriptor and stay cache-friendly. Alignment fix-up for arbitrary
+ * offsets, sizes and buffers is handled internally through a pool of
+ * block-aligned bounce buffers, and already-aligned requests are read
+ * with zero copies. Safe for concurrent readers.
+ * @param path Archive file path
+ * @return Allocated I/O interface (must be freed with ziprand_io_free),
+ *         or NULL on non-Linux builds or filesystems without O_DIRECT
+ *         support (fall back to ziprand_io_file)
+ */
+ziprand_io_t* ziprand_io_file_direct(const char* path);
+
 /**
  * Create I/O interface from memory buffer
  * @param data Buffer pointer
@@ -193,6 +727,21 @@ ziprand_io_t* ziprand_io_file(const char* path);
  */
 ziprand_io_t* ziprand_io_memory(const void* data, size_t size);
 
+/**
+ * Create an I/O interface over a stored entry's byte range, for opening
+ * nested archives (e.g. a ZIP stored inside an outer ZIP) without
+ * extracting them. Reads are forwarded to the parent archive's backend
+ * with offsets translated, so the view is zero-copy and inherits the
+ * parent's pread/mmap performance; zero-copy mapping is forwarded when
+ * the parent backend supports it. The entry must be stored
+ * (compression method 0). The view borrows the parent: both the file
+ * handle's archive and the parent's I/O must outlive the returned
+ * interface.
+ * @param file Open handle for the stored entry
+ * @return Allocated I/O interface (must be freed with ziprand_io_free)
+ */
+ziprand_io_t* ziprand_io_subrange(ziprand_file_t* file);
+
 /**
  * Free I/O interface created by helper functions
  * @param io I/O interface
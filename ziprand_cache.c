@@ -0,0 +1,228 @@
+/* Optional per-archive block cache.
+ *
+ * Fixed capacity, power-of-two aligned blocks, 4-way set-associative with
+ * per-slot LRU ticks: eviction never has to maintain a separate index, and
+ * the hit path only takes the shared side of a reader/writer lock, so
+ * concurrent readers on hot blocks do not serialize against each other.
+ * Reads of two blocks or more bypass the cache entirely to keep bulk
+ * scans from flushing the hot set.
+ */
+/* Enable POSIX extensions for pthread rwlocks */
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "ziprand_internal.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK cache_lock_t;
+#define cache_lock_init(l)    InitializeSRWLock(l)
+#define cache_lock_destroy(l) ((void)(l))
+#define cache_lock_rd(l)      AcquireSRWLockShared(l)
+#define cache_unlock_rd(l)    ReleaseSRWLockShared(l)
+#define cache_lock_wr(l)      AcquireSRWLockExclusive(l)
+#define cache_unlock_wr(l)    ReleaseSRWLockExclusive(l)
+#else
+#include <pthread.h>
+typedef pthread_rwlock_t cache_lock_t;
+#define cache_lock_init(l)    pthread_rwlock_init((l), NULL)
+#define cache_lock_destroy(l) pthread_rwlock_destroy(l)
+#define cache_lock_rd(l)      pthread_rwlock_rdlock(l)
+#define cache_unlock_rd(l)    pthread_rwlock_unlock(l)
+#define cache_lock_wr(l)      pthread_rwlock_wrlock(l)
+#define cache_unlock_wr(l)    pthread_rwlock_unlock(l)
+#endif
+
+#define CACHE_WAYS 4
+
+typedef struct {
+    int valid;
+    uint64_t block; /* block number (offset / block_size) */
+    uint32_t tick;  /* last-use stamp for within-set LRU */
+    uint32_t len;   /* valid bytes (short only in the final block) */
+} cache_slot_t;
+
+struct ziprand_cache {
+    size_t block_size; /* power of two */
+    size_t set_count;  /* power of two */
+    cache_slot_t* slots; /* set_count * CACHE_WAYS */
+    uint8_t* data;       /* slot payloads, one contiguous allocation */
+    uint32_t tick;
+    cache_lock_t lock;
+};
+
+static size_t round_up_pow2(size_t v)
+{
+    size_t p = 1;
+    while (p < v)
+        p <<= 1;
+    return p;
+}
+
+ziprand_cache_t* ziprand_cache_new(size_t block_size, size_t block_count)
+{
+    if (block_count == 0)
+        return NULL;
+
+    ziprand_cache_t* cache = calloc(1, sizeof(ziprand_cache_t));
+    if (!cache)
+        return NULL;
+
+    cache->block_size = round_up_pow2(block_size ? block_size : ZIPRAND_CACHE_DEFAULT_BLOCK);
+    cache->set_count = round_up_pow2((block_count + CACHE_WAYS - 1) / CACHE_WAYS);
+
+    size_t slot_count = cache->set_count * CACHE_WAYS;
+    cache->slots = calloc(slot_count, sizeof(cache_slot_t));
+    cache->data = malloc(slot_count * cache->block_size);
+    if (!cache->slots || !cache->data) {
+        free(cache->slots);
+        free(cache->data);
+        free(cache);
+        return NULL;
+    }
+
+    cache_lock_init(&cache->lock);
+    return cache;
+}
+
+void ziprand_cache_free(ziprand_cache_t* cache)
+{
+    if (!cache)
+        return;
+    cache_lock_destroy(&cache->lock);
+    free(cache->slots);
+    free(cache->data);
+    free(cache);
+}
+
+static inline cache_slot_t* cache_set(ziprand_cache_t* cache, uint64_t block)
+{
+    return &cache->slots[(block & (cache->set_count - 1)) * CACHE_WAYS];
+}
+
+static inline uint8_t* cache_slot_data(ziprand_cache_t* cache, cache_slot_t* slot)
+{
+    return cache->data + (size_t)(slot - cache->slots) * cache->block_size;
+}
+
+/* copy out of a cached block if present; returns bytes copied or -1 on miss */
+static int64_t cache_try_hit(
+    ziprand_cache_t* cache, uint64_t block, size_t block_off, void* buffer, size_t size)
+{
+    int64_t result = -1;
+
+    cache_lock_rd(&cache->lock);
+    cache_slot_t* set = cache_set(cache, block);
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        if (set[way].valid && set[way].block == block) {
+            if (block_off >= set[way].len) {
+                result = 0; /* beyond end of data within the final block */
+            } else {
+                size_t avail = set[way].len - block_off;
+                size_t take = size < avail ? size : avail;
+                memcpy(buffer, cache_slot_data(cache, &set[way]) + block_off, take);
+                result = (int64_t)take;
+            }
+            set[way].tick = cache->tick; /* racy stamp is fine for LRU */
+            break;
+        }
+    }
+    cache_unlock_rd(&cache->lock);
+
+    return result;
+}
+
+/* install a freshly read block, evicting the least recently used way */
+static void
+cache_install(ziprand_cache_t* cache, uint64_t block, const uint8_t* data, uint32_t len)
+{
+    cache_lock_wr(&cache->lock);
+    cache->tick++;
+
+    cache_slot_t* set = cache_set(cache, block);
+    cache_slot_t* victim = &set[0];
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        if (set[way].valid && set[way].block == block) {
+            victim = &set[way]; /* lost a race with another miss; refresh */
+            break;
+        }
+        if (!set[way].valid) {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].tick < victim->tick)
+            victim = &set[way];
+    }
+
+    victim->valid = 1;
+    victim->block = block;
+    victim->tick = cache->tick;
+    victim->len = len;
+    memcpy(cache_slot_data(cache, victim), data, len);
+    cache_unlock_wr(&cache->lock);
+}
+
+int64_t ziprand_cache_read(ziprand_cache_t* cache,
+                           const ziprand_io_t* io,
+                           uint64_t total_size,
+                           uint64_t offset,
+                           void* buffer,
+                           size_t size)
+{
+    /* large reads stream past the cache so bulk scans don't evict hot blocks */
+    if (size >= cache->block_size * 2)
+        return io->read(io->ctx, offset, buffer, size);
+
+    if (offset >= total_size)
+        return 0;
+    if (size > total_size - offset)
+        size = (size_t)(total_size - offset);
+
+    uint8_t* out = buffer;
+    size_t copied = 0;
+    while (copied < size) {
+        uint64_t pos = offset + copied;
+        uint64_t block = pos / cache->block_size;
+        size_t block_off = (size_t)(pos % cache->block_size);
+        size_t take = size - copied;
+        if (take > cache->block_size - block_off)
+            take = cache->block_size - block_off;
+
+        int64_t got = cache_try_hit(cache, block, block_off, out + copied, take);
+        if (got < 0) {
+            /* miss: read the whole aligned block, install it, serve from it */
+            uint64_t block_start = block * cache->block_size;
+            uint64_t block_len = total_size - block_start;
+            if (block_len > cache->block_size)
+                block_len = cache->block_size;
+
+            uint8_t* temp = malloc(cache->block_size);
+            if (!temp)
+                return copied ? (int64_t)copied : -1;
+
+            int64_t bytes_read = io->read(io->ctx, block_start, temp, (size_t)block_len);
+            if (bytes_read <= 0) {
+                free(temp);
+                return copied ? (int64_t)copied : bytes_read;
+            }
+            cache_install(cache, block, temp, (uint32_t)bytes_read);
+
+            got = 0;
+            if (block_off < (size_t)bytes_read) {
+                size_t avail = (size_t)bytes_read - block_off;
+                got = (int64_t)(take < avail ? take : avail);
+                memcpy(out + copied, temp + block_off, (size_t)got);
+            }
+            free(temp);
+        }
+
+        copied += (size_t)got;
+        if ((size_t)got < take)
+            break; /* end of data */
+    }
+
+    return (int64_t)copied;
+}
@@ -0,0 +1,144 @@
+/* Process-level refcounted archive cache.
+ *
+ * ziprand_open_cached keys parsed archives on (path, size, mtime): the
+ * first opener pays for the CD parse, every later opener of the same
+ * unchanged file gets the same ziprand_archive_t back for the cost of a
+ * stat and a refcount bump, and the last ziprand_close tears it down.
+ * Data offsets are resolved eagerly on first open, so the shared entry
+ * table is immutable and the read path needs no locking; the registry
+ * mutex is only taken on open and close. A changed file (different size
+ * or mtime) gets a fresh cache entry; the stale archive stays alive
+ * until its remaining holders close it.
+ */
+#include "ziprand_internal.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define CACHE_LOCK()   pthread_mutex_lock(&cache_mutex)
+#define CACHE_UNLOCK() pthread_mutex_unlock(&cache_mutex)
+#else
+#include <windows.h>
+
+static SRWLOCK cache_mutex = SRWLOCK_INIT;
+#define CACHE_LOCK()   AcquireSRWLockExclusive(&cache_mutex)
+#define CACHE_UNLOCK() ReleaseSRWLockExclusive(&cache_mutex)
+#endif
+
+typedef struct cached_archive {
+    struct cached_archive* next;
+    char* path;
+    uint64_t size;
+    uint64_t mtime;
+    int refcount; /* guarded by cache_mutex */
+    int stale;    /* file changed on disk; skip for new opens */
+    ziprand_archive_t* archive;
+    ziprand_io_t* io; /* owned by the cache node */
+} cached_archive_t;
+
+static cached_archive_t* cache_head;
+
+ziprand_archive_t* ziprand_open_cached(const char* path)
+{
+    if (!path)
+        return NULL;
+
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return NULL;
+
+    CACHE_LOCK();
+    for (cached_archive_t* node = cache_head; node; node = node->next) {
+        if (node->stale || strcmp(node->path, path) != 0)
+            continue;
+
+        if (node->size == (uint64_t)st.st_size && node->mtime == (uint64_t)st.st_mtime) {
+            node->refcount++;
+            CACHE_UNLOCK();
+            return node->archive;
+        }
+
+        /* the file changed under the cache: new openers get a fresh
+         * parse, remaining holders keep the old archive alive */
+        node->stale = 1;
+        break;
+    }
+    CACHE_UNLOCK();
+
+    /* parse outside the lock; concurrent first opens may race and parse
+     * twice, in which case each resulting archive is simply shared by
+     * whoever found it */
+    ziprand_io_t* io = ziprand_io_file(path);
+    if (!io)
+        return NULL;
+    ziprand_archive_t* archive = ziprand_open(io);
+    if (!archive) {
+        ziprand_io_free(io);
+        return NULL;
+    }
+
+    cached_archive_t* node = malloc(sizeof(cached_archive_t));
+    char* path_copy = node ? malloc(strlen(path) + 1) : NULL;
+
+    /* resolve every data offset now: afterwards nothing writes to the
+     * shared entry table and readers need no synchronization */
+    if (!path_copy || ziprand_resolve_offsets(archive) != ZIPRAND_OK) {
+        free(path_copy);
+        free(node);
+        ziprand_close(archive);
+        free(io);
+        return NULL;
+    }
+    strcpy(path_copy, path);
+
+    node->path = path_copy;
+    node->size = (uint64_t)st.st_size;
+    node->mtime = (uint64_t)st.st_mtime;
+    node->refcount = 1;
+    node->stale = 0;
+    node->archive = archive;
+    node->io = io;
+    archive->cached = 1;
+
+    CACHE_LOCK();
+    node->next = cache_head;
+    cache_head = node;
+    CACHE_UNLOCK();
+
+    return archive;
+}
+
+/* drop one reference; returns the remaining count. At zero the registry
+ * node is reclaimed and the caller (ziprand_close) finishes the teardown. */
+int ziprand_cached_release(ziprand_archive_t* archive)
+{
+    CACHE_LOCK();
+
+    cached_archive_t* node = NULL;
+    cached_archive_t** link;
+    for (link = &cache_head; *link; link = &(*link)->next) {
+        if ((*link)->archive == archive) {
+            node = *link;
+            break;
+        }
+    }
+
+    int remaining = 0;
+    if (node) {
+        remaining = --node->refcount;
+        if (remaining == 0)
+            *link = node->next;
+    }
+    CACHE_UNLOCK();
+
+    if (node && remaining == 0) {
+        free(node->path);
+        free(node->io);
+        free(node);
+    }
+    return remaining;
+}
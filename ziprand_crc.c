@@ -0,0 +1,131 @@
+/* CRC-32 (ISO-HDLC, reflected polynomial 0xEDB88320) over entry data.
+ *
+ * ZIP checksums use the ISO-HDLC polynomial, which rules out the x86
+ * crc32 instruction (that computes CRC-32C, a different polynomial), so
+ * x86 and the portable path use a slice-by-8 table kernel that processes
+ * eight bytes per iteration. AArch64 has native instructions for this
+ * polynomial; they are used when the kernel reports CRC32 support in
+ * HWCAP.
+ */
+/* Enable POSIX extensions for pthread_once */
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "ziprand_internal.h"
+
+#if defined(__aarch64__) && defined(__linux__)
+#define ZIPRAND_CRC_ARM 1
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+static uint32_t crc_table[8][256];
+
+static void crc_table_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c >> 1) ^ ((c & 1) ? 0xEDB88320u : 0);
+        crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++)
+            crc_table[t][i] =
+                (crc_table[t - 1][i] >> 8) ^ crc_table[0][crc_table[t - 1][i] & 0xFF];
+    }
+}
+
+/* one-time table construction with real synchronization: readers may hit
+ * ziprand_crc32 concurrently (shared cached archives, extraction
+ * workers), and a plain ready flag would let a second thread observe the
+ * flag before the table stores on weakly-ordered targets */
+#ifdef _WIN32
+#include <windows.h>
+static INIT_ONCE crc_table_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK crc_table_init_cb(PINIT_ONCE once, PVOID param, PVOID* ctx)
+{
+    (void)once;
+    (void)param;
+    (void)ctx;
+    crc_table_init();
+    return TRUE;
+}
+#define crc_table_ensure() InitOnceExecuteOnce(&crc_table_once, crc_table_init_cb, NULL, NULL)
+#else
+#include <pthread.h>
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+#define crc_table_ensure() pthread_once(&crc_table_once, crc_table_init)
+#endif
+
+static uint32_t crc32_slice8(uint32_t crc, const uint8_t* p, size_t len)
+{
+    crc = ~crc;
+
+    while (((uintptr_t)p & 7) && len) {
+        crc = (crc >> 8) ^ crc_table[0][(crc ^ *p++) & 0xFF];
+        len--;
+    }
+
+    while (len >= 8) {
+        uint32_t lo = read_u32_le(p) ^ crc;
+        uint32_t hi = read_u32_le(p + 4);
+        crc = crc_table[7][lo & 0xFF] ^ crc_table[6][(lo >> 8) & 0xFF] ^
+              crc_table[5][(lo >> 16) & 0xFF] ^ crc_table[4][lo >> 24] ^
+              crc_table[3][hi & 0xFF] ^ crc_table[2][(hi >> 8) & 0xFF] ^
+              crc_table[1][(hi >> 16) & 0xFF] ^ crc_table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+
+    while (len--)
+        crc = (crc >> 8) ^ crc_table[0][(crc ^ *p++) & 0xFF];
+
+    return ~crc;
+}
+
+#ifdef ZIPRAND_CRC_ARM
+
+__attribute__((target("+crc"))) static uint32_t
+crc32_arm(uint32_t crc, const uint8_t* p, size_t len)
+{
+    crc = ~crc;
+
+    while (((uintptr_t)p & 7) && len) {
+        crc = __crc32b(crc, *p++);
+        len--;
+    }
+    while (len >= 8) {
+        crc = __crc32d(crc, read_u64_le(p));
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc = __crc32b(crc, *p++);
+
+    return ~crc;
+}
+
+static int crc_have_arm(void)
+{
+    static int have = -1;
+    if (have < 0)
+        have = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+    return have;
+}
+
+#endif /* ZIPRAND_CRC_ARM */
+
+uint32_t ziprand_crc32(uint32_t crc, const void* data, size_t len)
+{
+#ifdef ZIPRAND_CRC_ARM
+    if (crc_have_arm())
+        return crc32_arm(crc, data, len);
+#endif
+    crc_table_ensure();
+    return crc32_slice8(crc, data, len);
+}
@@ -0,0 +1,238 @@
+/* Random access into DEFLATE (method 8) entries.
+ *
+ * Modeled on the access-point scheme from zlib's examples/zran.c: while
+ * inflating forward we record, roughly every INFLATE_SPAN bytes of output,
+ * the bit position of a deflate block boundary plus the 32 KiB sliding
+ * window at that point. A later ziprand_fread_at only re-inflates from the
+ * nearest recorded checkpoint instead of from the start of the entry. The
+ * index is built lazily as reads advance through the entry, and a live
+ * stream is kept between calls so sequential reads never restart.
+ *
+ * Like ziprand_file_t itself, one handle must not be used from multiple
+ * threads concurrently.
+ */
+#include "ziprand_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define INFLATE_SPAN    (1u << 20) /* target output distance between checkpoints */
+#define INFLATE_WINSIZE 32768u     /* deflate sliding window size */
+#define INFLATE_CHUNK   65536u     /* compressed input buffer size */
+
+typedef struct {
+    uint64_t out_off; /* uncompressed offset of this checkpoint */
+    uint64_t in_off;  /* compressed offset within the entry data */
+    int bits;         /* bits of the byte at in_off - 1 still pending */
+    unsigned window_len;
+    uint8_t window[INFLATE_WINSIZE];
+} inflate_point_t;
+
+struct ziprand_inflate {
+    ziprand_archive_t* archive;
+    const ziprand_entry_t* entry;
+
+    inflate_point_t* points; /* checkpoints, sorted by out_off */
+    size_t point_count;
+    size_t point_cap;
+    uint64_t indexed_to; /* output offset the checkpoint pass has reached */
+
+    /* live stream state for sequential continuation */
+    z_stream strm;
+    int active;
+    uint64_t out_pos; /* uncompressed offset of the next byte to produce */
+    uint64_t in_pos;  /* compressed offset of the next input refill */
+    uint8_t in_buf[INFLATE_CHUNK];
+};
+
+ziprand_inflate_t* ziprand_inflate_new(ziprand_archive_t* archive, const ziprand_entry_t* entry)
+{
+    ziprand_inflate_t* zf = calloc(1, sizeof(ziprand_inflate_t));
+    if (!zf)
+        return NULL;
+    zf->archive = archive;
+    zf->entry = entry;
+    return zf;
+}
+
+void ziprand_inflate_free(ziprand_inflate_t* zf)
+{
+    if (!zf)
+        return;
+    if (zf->active)
+        inflateEnd(&zf->strm);
+    free(zf->points);
+    free(zf);
+}
+
+/* pull the next chunk of compressed entry data into in_buf */
+static int inflate_refill(ziprand_inflate_t* zf)
+{
+    uint64_t remaining = zf->entry->compressed_size - zf->in_pos;
+    size_t to_read = remaining < INFLATE_CHUNK ? (size_t)remaining : INFLATE_CHUNK;
+    if (to_read == 0)
+        return -1; /* input exhausted before the stream ended */
+
+    int64_t bytes_read = ziprand_archive_read(
+        zf->archive, zf->entry->data_offset + zf->in_pos, zf->in_buf, to_read);
+    if (bytes_read <= 0)
+        return -1;
+
+    zf->in_pos += bytes_read;
+    zf->strm.next_in = zf->in_buf;
+    zf->strm.avail_in = (uInt)bytes_read;
+    return 0;
+}
+
+/* (re)start the live stream, from a checkpoint or from the entry start */
+static int inflate_restart(ziprand_inflate_t* zf, const inflate_point_t* point)
+{
+    if (zf->active) {
+        inflateEnd(&zf->strm);
+        zf->active = 0;
+    }
+
+    memset(&zf->strm, 0, sizeof(zf->strm));
+    if (inflateInit2(&zf->strm, -15) != Z_OK) /* raw deflate */
+        return -1;
+    zf->active = 1;
+
+    if (point) {
+        zf->in_pos = point->in_off;
+        zf->out_pos = point->out_off;
+
+        if (point->bits) {
+            uint8_t byte;
+            if (ziprand_archive_read(
+                    zf->archive, zf->entry->data_offset + point->in_off - 1, &byte, 1) != 1)
+                return -1;
+            if (inflatePrime(&zf->strm, point->bits, byte >> (8 - point->bits)) != Z_OK)
+                return -1;
+        }
+        if (point->window_len > 0 &&
+            inflateSetDictionary(&zf->strm, point->window, point->window_len) != Z_OK)
+            return -1;
+    } else {
+        zf->in_pos = 0;
+        zf->out_pos = 0;
+    }
+
+    zf->strm.avail_in = 0;
+    return 0;
+}
+
+/* record a checkpoint at the current block boundary */
+static int inflate_add_point(ziprand_inflate_t* zf)
+{
+    if (zf->point_count == zf->point_cap) {
+        size_t cap = zf->point_cap ? zf->point_cap * 2 : 8;
+        inflate_point_t* points = realloc(zf->points, cap * sizeof(inflate_point_t));
+        if (!points)
+            return -1;
+        zf->points = points;
+        zf->point_cap = cap;
+    }
+
+    inflate_point_t* point = &zf->points[zf->point_count];
+    point->out_off = zf->out_pos;
+    point->in_off = zf->in_pos - zf->strm.avail_in;
+    point->bits = zf->strm.data_type & 7;
+    point->window_len = INFLATE_WINSIZE;
+    if (inflateGetDictionary(&zf->strm, point->window, &point->window_len) != Z_OK)
+        return -1;
+
+    zf->point_count++;
+    return 0;
+}
+
+/* best checkpoint at or before target, or NULL */
+static const inflate_point_t* inflate_find_point(ziprand_inflate_t* zf, uint64_t target)
+{
+    const inflate_point_t* best = NULL;
+    size_t lo = 0, hi = zf->point_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (zf->points[mid].out_off <= target) {
+            best = &zf->points[mid];
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return best;
+}
+
+/* inflate forward from out_pos: discard bytes up to target, then copy up to
+ * size bytes into buffer. Checkpoints are recorded while crossing output
+ * the index has not covered yet. Returns bytes copied or -1. */
+static int64_t
+inflate_forward(ziprand_inflate_t* zf, uint64_t target, uint8_t* buffer, size_t size)
+{
+    uint8_t discard[INFLATE_WINSIZE];
+    size_t copied = 0;
+
+    while (copied < size) {
+        if (zf->out_pos < target) {
+            uint64_t gap = target - zf->out_pos;
+            zf->strm.next_out = discard;
+            zf->strm.avail_out = gap < sizeof(discard) ? (uInt)gap : (uInt)sizeof(discard);
+        } else {
+            zf->strm.next_out = buffer + copied;
+            zf->strm.avail_out = (uInt)(size - copied);
+        }
+        uInt want = zf->strm.avail_out;
+
+        if (zf->strm.avail_in == 0 && inflate_refill(zf) != 0)
+            return -1;
+
+        int ret = inflate(&zf->strm, Z_BLOCK);
+        if (ret != Z_OK && ret != Z_STREAM_END)
+            return -1;
+
+        uInt produced = want - zf->strm.avail_out;
+        if (zf->out_pos >= target)
+            copied += produced;
+        zf->out_pos += produced;
+
+        /* extend the checkpoint index through fresh territory: record a
+         * point at block boundaries once a span has passed since the last */
+        if (ret == Z_OK && zf->out_pos > zf->indexed_to && (zf->strm.data_type & 128) &&
+            !(zf->strm.data_type & 64)) {
+            uint64_t last = zf->point_count ? zf->points[zf->point_count - 1].out_off : 0;
+            if (zf->point_count == 0 || zf->out_pos >= last + INFLATE_SPAN) {
+                if (inflate_add_point(zf) != 0)
+                    return -1;
+            }
+        }
+        if (zf->out_pos > zf->indexed_to)
+            zf->indexed_to = zf->out_pos;
+
+        if (ret == Z_STREAM_END)
+            break;
+    }
+
+    return (int64_t)copied;
+}
+
+int64_t ziprand_inflate_read_at(ziprand_inflate_t* zf, uint64_t offset, void* buffer, size_t size)
+{
+    if (!zf)
+        return -1;
+
+    /* continue the live stream when the read is sequential and no recorded
+     * checkpoint gets us closer; otherwise restart from the best one */
+    const inflate_point_t* point = inflate_find_point(zf, offset);
+    int continue_live = zf->active && zf->out_pos <= offset &&
+                        (!point || point->out_off <= zf->out_pos);
+    if (!continue_live && inflate_restart(zf, point) != 0)
+        return -1;
+
+    int64_t result = inflate_forward(zf, offset, buffer, size);
+    if (result < 0 && zf->active) {
+        /* leave no half-consumed stream behind */
+        inflateEnd(&zf->strm);
+        zf->active = 0;
+    }
+    return result;
+}
@@ -0,0 +1,271 @@
+/* Parallel multi-entry extraction.
+ *
+ * ziprand_extract_batch materializes a set of entries under a destination
+ * directory using a worker pool. The work list is sorted by data_offset
+ * before the pool starts, so with more workers than queue depth the
+ * source archive is still read in roughly ascending offset order -
+ * sequential for spinning media, and dense enough to keep NVMe request
+ * queues full. Each worker streams one entry at a time through its own
+ * chunk buffer, so source reads of the next chunk overlap destination
+ * writes of the previous one across workers. Workers claim entries via a
+ * shared atomic cursor; the first error stops new work from being
+ * claimed and is returned once the pool drains.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "ziprand_internal.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define extract_mkdir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#define extract_mkdir(path) mkdir((path), 0755)
+#endif
+
+/* per-worker streaming buffer size */
+#define EXTRACT_CHUNK (1u << 20)
+
+#define EXTRACT_MAX_THREADS 64
+
+typedef struct {
+    ziprand_archive_t* archive;
+    const char* dest_dir;
+    const ziprand_entry_t** order; /* entries sorted by data_offset */
+    size_t count;
+    atomic_size_t next;       /* shared work cursor */
+    atomic_int error;         /* first ziprand_error_t hit, 0 while clean */
+} extract_pool_t;
+
+static void extract_fail(extract_pool_t* pool, ziprand_error_t err)
+{
+    int expected = 0;
+    atomic_compare_exchange_strong(&pool->error, &expected, (int)err);
+}
+
+/* entry names come from untrusted archives: refuse absolute paths and
+ * any ".." component so extraction cannot escape dest_dir. Both
+ * separators are honoured everywhere, since an archive written on
+ * Windows may use backslashes */
+static int extract_name_safe(const char* name)
+{
+    if (name[0] == '/' || name[0] == '\\' || name[0] == '\0')
+        return 0;
+#ifdef _WIN32
+    /* drive-letter absolutes ("C:\evil", "C:evil") */
+    if (name[0] != '\0' && name[1] == ':')
+        return 0;
+#endif
+    const char* p = name;
+    for (;;) {
+        size_t len = 0;
+        while (p[len] && p[len] != '/' && p[len] != '\\')
+            len++;
+        if (len == 2 && p[0] == '.' && p[1] == '.')
+            return 0;
+        if (!p[len])
+            break;
+        p += len + 1;
+    }
+    return 1;
+}
+
+/* create every directory on the path; existing directories are fine */
+static int extract_mkdirs(char* path, int full)
+{
+    for (char* p = path + 1; *p; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if (extract_mkdir(path) != 0 && errno != EEXIST) {
+            *p = '/';
+            return -1;
+        }
+        *p = '/';
+    }
+    if (full && extract_mkdir(path) != 0 && errno != EEXIST)
+        return -1;
+    return 0;
+}
+
+static ziprand_error_t
+extract_one(extract_pool_t* pool, const ziprand_entry_t* entry, uint8_t* chunk)
+{
+    if (!extract_name_safe(entry->name))
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    size_t path_len = strlen(pool->dest_dir) + 1 + strlen(entry->name) + 1;
+    char* path = malloc(path_len);
+    if (!path)
+        return ZIPRAND_ERR_NOMEM;
+    snprintf(path, path_len, "%s/%s", pool->dest_dir, entry->name);
+
+    /* directory entries carry no data */
+    size_t name_len = strlen(entry->name);
+    if (entry->name[name_len - 1] == '/') {
+        int rc = extract_mkdirs(path, 1);
+        free(path);
+        return rc == 0 ? ZIPRAND_OK : ZIPRAND_ERR_IO;
+    }
+
+    if (extract_mkdirs(path, 0) != 0) {
+        free(path);
+        return ZIPRAND_ERR_IO;
+    }
+
+    ziprand_file_t* src = ziprand_fopen(pool->archive, entry);
+    if (!src) {
+        free(path);
+        return ZIPRAND_ERR_IO;
+    }
+
+    FILE* dst = fopen(path, "wb");
+    free(path);
+    if (!dst) {
+        ziprand_fclose(src);
+        return ZIPRAND_ERR_IO;
+    }
+
+    ziprand_error_t err = ZIPRAND_OK;
+    uint64_t remaining = entry->uncompressed_size;
+    while (remaining > 0) {
+        size_t want = remaining < EXTRACT_CHUNK ? (size_t)remaining : EXTRACT_CHUNK;
+        if (ziprand_fread(src, chunk, want) != (int64_t)want ||
+            fwrite(chunk, 1, want, dst) != want) {
+            err = ZIPRAND_ERR_IO;
+            break;
+        }
+        remaining -= want;
+    }
+
+    ziprand_fclose(src);
+    if (fclose(dst) != 0 && err == ZIPRAND_OK)
+        err = ZIPRAND_ERR_IO;
+    return err;
+}
+
+static void* extract_worker_run(void* arg)
+{
+    extract_pool_t* pool = arg;
+
+    uint8_t* chunk = malloc(EXTRACT_CHUNK);
+    if (!chunk) {
+        extract_fail(pool, ZIPRAND_ERR_NOMEM);
+        return NULL;
+    }
+
+    for (;;) {
+        if (atomic_load_explicit(&pool->error, memory_order_relaxed) != 0)
+            break;
+        size_t i = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+        if (i >= pool->count)
+            break;
+
+        ziprand_error_t err = extract_one(pool, pool->order[i], chunk);
+        if (err != ZIPRAND_OK)
+            extract_fail(pool, err);
+    }
+
+    free(chunk);
+    return NULL;
+}
+
+static int extract_order_cmp(const void* a, const void* b)
+{
+    const ziprand_entry_t* ea = *(const ziprand_entry_t* const*)a;
+    const ziprand_entry_t* eb = *(const ziprand_entry_t* const*)b;
+    uint64_t oa = ea->data_offset ? ea->data_offset : ea->offset;
+    uint64_t ob = eb->data_offset ? eb->data_offset : eb->offset;
+    if (oa < ob)
+        return -1;
+    if (oa > ob)
+        return 1;
+    return 0;
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+#include <unistd.h>
+
+/* pick the worker count: bounded by cores, the caller's cap, and the
+ * amount of work available */
+static int extract_resolve_threads(const ziprand_extract_opts_t* opts, size_t count)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int nthreads = cores > 0 ? (int)cores : 1;
+
+    if (opts && opts->threads > 0 && nthreads > opts->threads)
+        nthreads = opts->threads;
+    if (nthreads > EXTRACT_MAX_THREADS)
+        nthreads = EXTRACT_MAX_THREADS;
+    if ((size_t)nthreads > count)
+        nthreads = (int)count;
+    return nthreads > 1 ? nthreads : 1;
+}
+
+#endif /* !_WIN32 */
+
+ziprand_error_t ziprand_extract_batch(ziprand_archive_t* archive,
+                                      const ziprand_entry_t* const* entries,
+                                      size_t count,
+                                      const char* dest_dir,
+                                      const ziprand_extract_opts_t* opts)
+{
+    if (!archive || (!entries && count > 0) || !dest_dir)
+        return ZIPRAND_ERR_INVALID_PARAM;
+    if (count == 0)
+        return ZIPRAND_OK;
+
+    /* resolve every data offset up front: the sort below gets real data
+     * positions and ziprand_fopen stops mutating the entry table, which
+     * keeps the workers free of write/write races */
+    ziprand_error_t err = ziprand_resolve_offsets(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    const ziprand_entry_t** order = malloc(count * sizeof(*order));
+    if (!order)
+        return ZIPRAND_ERR_NOMEM;
+    memcpy(order, entries, count * sizeof(*order));
+    qsort(order, count, sizeof(*order), extract_order_cmp);
+
+    extract_pool_t pool;
+    pool.archive = archive;
+    pool.dest_dir = dest_dir;
+    pool.order = order;
+    pool.count = count;
+    atomic_init(&pool.next, 0);
+    atomic_init(&pool.error, 0);
+
+#ifndef _WIN32
+    int nthreads = extract_resolve_threads(opts, count);
+    if (nthreads > 1) {
+        pthread_t* tids = malloc((size_t)nthreads * sizeof(pthread_t));
+        if (tids) {
+            int spawned = 0;
+            for (; spawned < nthreads - 1; spawned++) {
+                if (pthread_create(&tids[spawned], NULL, extract_worker_run, &pool) != 0)
+                    break;
+            }
+            extract_worker_run(&pool); /* the caller's thread pulls its weight */
+            for (int t = 0; t < spawned; t++)
+                pthread_join(tids[t], NULL);
+            free(tids);
+            free(order);
+            return (ziprand_error_t)atomic_load(&pool.error);
+        }
+    }
+#else
+    (void)opts;
+#endif
+
+    extract_worker_run(&pool);
+    free(order);
+    return (ziprand_error_t)atomic_load(&pool.error);
+}
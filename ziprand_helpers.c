@@ -1,6 +1,7 @@
-/* Enable POSIX extensions for pread */
+/* Enable POSIX extensions for pread and preadv */
 #ifndef _MSC_VER
 #define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
 #endif
 
 #include "ziprand.h"
@@ -13,9 +14,12 @@
 #include <windows.h>
 #else
 #include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #endif
 
 /* File I/O using native handles for thread-safe pread */
@@ -47,6 +51,40 @@ static int64_t file_read(void* ctx, uint64_t offset, void* buffer, size_t size)
 #endif
 }
 
+#ifndef _WIN32
+static int64_t file_readv(void* ctx, uint64_t offset, const ziprand_iovec_t* iov, size_t iov_count)
+{
+    file_io_ctx_t* fctx = ctx;
+    int64_t total = 0;
+
+    /* preadv caps the vector length at IOV_MAX; issue in slices */
+    struct iovec vec[64];
+    size_t i = 0;
+    while (i < iov_count) {
+        size_t n = iov_count - i;
+        if (n > sizeof(vec) / sizeof(vec[0]))
+            n = sizeof(vec) / sizeof(vec[0]);
+        size_t slice_bytes = 0;
+        for (size_t j = 0; j < n; j++) {
+            vec[j].iov_base = iov[i + j].buffer;
+            vec[j].iov_len = iov[i + j].size;
+            slice_bytes += iov[i + j].size;
+        }
+
+        ssize_t bytes_read = preadv(fctx->fd, vec, (int)n, offset + total);
+        if (bytes_read < 0)
+            return -1;
+        total += bytes_read;
+        if ((size_t)bytes_read < slice_bytes)
+            break; /* short read (end of file) */
+
+        i += n;
+    }
+
+    return total;
+}
+#endif
+
 static int64_t file_size(void* ctx)
 {
     file_io_ctx_t* fctx = ctx;
@@ -66,6 +104,31 @@ static int64_t file_size(void* ctx)
 #endif
 }
 
+#ifndef _WIN32
+static int file_advise(void* ctx, uint64_t offset, uint64_t size, ziprand_advise_t hint)
+{
+    file_io_ctx_t* fctx = ctx;
+    int advice;
+    switch (hint) {
+    case ZIPRAND_ADVISE_WILLNEED:
+        advice = POSIX_FADV_WILLNEED;
+        break;
+    case ZIPRAND_ADVISE_DONTNEED:
+        advice = POSIX_FADV_DONTNEED;
+        break;
+    case ZIPRAND_ADVISE_SEQUENTIAL:
+        advice = POSIX_FADV_SEQUENTIAL;
+        break;
+    case ZIPRAND_ADVISE_RANDOM:
+        advice = POSIX_FADV_RANDOM;
+        break;
+    default:
+        return -1;
+    }
+    return posix_fadvise(fctx->fd, (off_t)offset, (off_t)size, advice) == 0 ? 0 : -1;
+}
+#endif
+
 static void file_close(void* ctx)
 {
     file_io_ctx_t* fctx = ctx;
@@ -127,6 +190,198 @@ ziprand_io_t* ziprand_io_file(const char* path)
     io->read = file_read;
     io->get_size = file_size;
     io->close = file_close;
+    io->map = NULL;
+#ifdef _WIN32
+    io->readv = NULL;
+#else
+    io->readv = file_readv;
+#endif
+    io->submit = NULL;
+    io->reap = NULL;
+#ifdef _WIN32
+    io->advise = NULL;
+#else
+    io->advise = file_advise;
+#endif
+
+    return io;
+}
+
+/* memory-mapped file I/O: the whole file is mapped once, reads are plain
+ * copies out of the mapping, and the map callback hands out zero-copy
+ * pointers straight into page cache */
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} mmap_io_ctx_t;
+
+static int64_t mmap_read(void* ctx, uint64_t offset, void* buffer, size_t size)
+{
+    mmap_io_ctx_t* mctx = ctx;
+
+    if (offset >= mctx->size)
+        return 0;
+
+    size_t remaining = mctx->size - offset;
+    size_t to_read = size < remaining ? size : remaining;
+
+    memcpy(buffer, mctx->base + offset, to_read);
+    return to_read;
+}
+
+static int64_t mmap_size(void* ctx)
+{
+    mmap_io_ctx_t* mctx = ctx;
+    return mctx->size;
+}
+
+static const void* mmap_map(void* ctx, uint64_t offset, size_t size)
+{
+    mmap_io_ctx_t* mctx = ctx;
+
+    if (offset > mctx->size || size > mctx->size - offset)
+        return NULL;
+    return mctx->base + offset;
+}
+
+#ifndef _WIN32
+static int mmap_advise(void* ctx, uint64_t offset, uint64_t size, ziprand_advise_t hint)
+{
+    mmap_io_ctx_t* mctx = ctx;
+    int advice;
+    switch (hint) {
+    case ZIPRAND_ADVISE_WILLNEED:
+        advice = MADV_WILLNEED;
+        break;
+    case ZIPRAND_ADVISE_DONTNEED:
+        advice = MADV_DONTNEED;
+        break;
+    case ZIPRAND_ADVISE_SEQUENTIAL:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case ZIPRAND_ADVISE_RANDOM:
+        advice = MADV_RANDOM;
+        break;
+    default:
+        return -1;
+    }
+
+    if (offset > mctx->size)
+        return -1;
+    if (size == 0 || size > mctx->size - offset)
+        size = mctx->size - offset;
+
+    /* madvise wants page-aligned addresses; widen to page boundaries */
+    long page = sysconf(_SC_PAGESIZE);
+    uint64_t start = offset & ~((uint64_t)page - 1);
+    uint64_t end = offset + size;
+    return madvise((void*)(mctx->base + start), (size_t)(end - start), advice) == 0 ? 0 : -1;
+}
+#endif
+
+static void mmap_close(void* ctx)
+{
+    mmap_io_ctx_t* mctx = ctx;
+#ifdef _WIN32
+    if (mctx->base)
+        UnmapViewOfFile(mctx->base);
+    if (mctx->mapping)
+        CloseHandle(mctx->mapping);
+    if (mctx->file != INVALID_HANDLE_VALUE)
+        CloseHandle(mctx->file);
+#else
+    if (mctx->base)
+        munmap((void*)mctx->base, mctx->size);
+#endif
+    free(mctx);
+}
+
+ziprand_io_t* ziprand_io_mmap(const char* path)
+{
+    if (!path)
+        return NULL;
+
+    mmap_io_ctx_t* mctx = calloc(1, sizeof(mmap_io_ctx_t));
+    if (!mctx)
+        return NULL;
+
+#ifdef _WIN32
+    mctx->file = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mctx->file == INVALID_HANDLE_VALUE) {
+        free(mctx);
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mctx->file, &size) || size.QuadPart == 0) {
+        CloseHandle(mctx->file);
+        free(mctx);
+        return NULL;
+    }
+    mctx->size = (size_t)size.QuadPart;
+
+    mctx->mapping = CreateFileMappingA(mctx->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mctx->mapping) {
+        CloseHandle(mctx->file);
+        free(mctx);
+        return NULL;
+    }
+
+    mctx->base = MapViewOfFile(mctx->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mctx->base) {
+        CloseHandle(mctx->mapping);
+        CloseHandle(mctx->file);
+        free(mctx);
+        return NULL;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(mctx);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        free(mctx);
+        return NULL;
+    }
+    mctx->size = (size_t)st.st_size;
+
+    void* base = mmap(NULL, mctx->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); /* the mapping keeps its own reference */
+    if (base == MAP_FAILED) {
+        free(mctx);
+        return NULL;
+    }
+    mctx->base = base;
+#endif
+
+    ziprand_io_t* io = malloc(sizeof(ziprand_io_t));
+    if (!io) {
+        mmap_close(mctx);
+        return NULL;
+    }
+
+    io->ctx = mctx;
+    io->read = mmap_read;
+    io->get_size = mmap_size;
+    io->close = mmap_close;
+    io->map = mmap_map;
+    io->readv = NULL;
+    io->submit = NULL;
+    io->reap = NULL;
+#ifdef _WIN32
+    io->advise = NULL;
+#else
+    io->advise = mmap_advise;
+#endif
 
     return io;
 }
@@ -157,6 +412,15 @@ static int64_t memory_size(void* ctx)
     return mctx->size;
 }
 
+static const void* memory_map(void* ctx, uint64_t offset, size_t size)
+{
+    memory_io_ctx_t* mctx = ctx;
+
+    if (offset > mctx->size || size > mctx->size - offset)
+        return NULL;
+    return mctx->data + offset;
+}
+
 static void memory_close(void* ctx)
 {
     free(ctx);
@@ -184,6 +448,11 @@ ziprand_io_t* ziprand_io_memory(const void* data, size_t size)
     io->read = memory_read;
     io->get_size = memory_size;
     io->close = memory_close;
+    io->map = memory_map;
+    io->readv = NULL;
+    io->submit = NULL;
+    io->reap = NULL;
+    io->advise = NULL; /* the buffer is already resident */
 
     return io;
 }
@@ -0,0 +1,275 @@
+/* HTTP(S) range-request I/O backend.
+ *
+ * One persistent libcurl easy handle per interface: the connection is
+ * kept alive across requests, so after the first round trip each read is
+ * a single Range GET on a warm connection. Two caches sit in front of
+ * the network: the archive tail (where the EOCD and central directory
+ * live) is fetched once with a suffix Range request that also yields the
+ * total size from Content-Range, so ziprand_open costs one round trip;
+ * and small reads elsewhere are coalesced into a larger window that
+ * absorbs neighbouring requests (local headers, small entries).
+ *
+ * The interface is not thread-safe; drive one interface from one thread
+ * at a time, like the io_uring backend.
+ */
+#define _POSIX_C_SOURCE 200809L /* strdup */
+
+#include "ziprand_internal.h"
+
+#ifdef ZIPRAND_HAVE_CURL
+
+#include <curl/curl.h>
+#include <stdio.h>
+#include <string.h>
+
+/* tail region fetched up front; sized to cover the EOCD search range
+ * plus a typical central directory */
+#define HTTP_TAIL_SIZE (1u << 20)
+
+/* reads below this size are widened to it, so clustered small reads hit
+ * the coalescing window instead of the network */
+#define HTTP_COALESCE_SIZE (256u << 10)
+
+typedef struct {
+    CURL* curl; /* persistent handle; connection reused across requests */
+    char* url;
+    int64_t size; /* total archive size, -1 until the tail fetch */
+
+    uint8_t* tail; /* cached tail region, NULL until first use */
+    uint64_t tail_off;
+    size_t tail_len;
+
+    uint8_t* window; /* coalescing window for small mid-archive reads */
+    uint64_t window_off;
+    size_t window_len;
+} http_io_ctx_t;
+
+/* curl write sink: fill a fixed-capacity buffer, discard overflow */
+typedef struct {
+    uint8_t* buf;
+    size_t len;
+    size_t cap;
+} http_sink_t;
+
+static size_t http_write_cb(char* data, size_t size, size_t nmemb, void* user)
+{
+    http_sink_t* sink = user;
+    size_t bytes = size * nmemb;
+    size_t room = sink->cap - sink->len;
+    size_t take = bytes < room ? bytes : room;
+    memcpy(sink->buf + sink->len, data, take);
+    sink->len += take;
+    return bytes; /* swallow overflow instead of aborting the transfer */
+}
+
+/* scan response headers for the total size in Content-Range */
+static size_t http_header_cb(char* data, size_t size, size_t nmemb, void* user)
+{
+    int64_t* total = user;
+    size_t bytes = size * nmemb;
+
+    /* "Content-Range: bytes X-Y/Z" (case-insensitive field name) */
+    const char prefix[] = "content-range:";
+    if (bytes > sizeof(prefix) - 1) {
+        size_t i;
+        for (i = 0; i < sizeof(prefix) - 1; i++) {
+            char c = data[i];
+            if (c >= 'A' && c <= 'Z')
+                c += 'a' - 'A';
+            if (c != prefix[i])
+                break;
+        }
+        if (i == sizeof(prefix) - 1) {
+            const char* slash = memchr(data, '/', bytes);
+            if (slash) {
+                int64_t value = 0;
+                for (const char* p = slash + 1; p < data + bytes && *p >= '0' && *p <= '9'; p++)
+                    value = value * 10 + (*p - '0');
+                if (value > 0)
+                    *total = value;
+            }
+        }
+    }
+    return bytes;
+}
+
+/* issue one Range GET; range is a curl range string ("start-end" or
+ * "-suffix"). Returns bytes received into sink, or -1 on error.
+ *
+ * allow_full controls whether a 200 (whole file) response is accepted:
+ * only the suffix tail fetch may see one, when the file is smaller than
+ * the requested suffix. For start-end requests a 200 means the server or
+ * a middlebox ignored Range, and the body is offset-0 bytes that must
+ * not be served as if they came from the requested offset. */
+static int64_t
+http_fetch(http_io_ctx_t* hctx, const char* range, http_sink_t* sink, int allow_full)
+{
+    curl_easy_setopt(hctx->curl, CURLOPT_URL, hctx->url);
+    curl_easy_setopt(hctx->curl, CURLOPT_RANGE, range);
+    curl_easy_setopt(hctx->curl, CURLOPT_WRITEFUNCTION, http_write_cb);
+    curl_easy_setopt(hctx->curl, CURLOPT_WRITEDATA, sink);
+    curl_easy_setopt(hctx->curl, CURLOPT_HEADERFUNCTION, http_header_cb);
+    curl_easy_setopt(hctx->curl, CURLOPT_HEADERDATA, &hctx->size);
+    curl_easy_setopt(hctx->curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(hctx->curl, CURLOPT_FAILONERROR, 1L);
+
+    if (curl_easy_perform(hctx->curl) != CURLE_OK)
+        return -1;
+
+    long status = 0;
+    curl_easy_getinfo(hctx->curl, CURLINFO_RESPONSE_CODE, &status);
+    if (status != 206 && !(status == 200 && allow_full))
+        return -1;
+    return (int64_t)sink->len;
+}
+
+/* fetch the archive tail with a suffix Range request; one round trip
+ * yields both the tail bytes and the total size via Content-Range */
+static ziprand_error_t http_load_tail(http_io_ctx_t* hctx)
+{
+    hctx->tail = malloc(HTTP_TAIL_SIZE);
+    if (!hctx->tail)
+        return ZIPRAND_ERR_NOMEM;
+
+    char range[32];
+    snprintf(range, sizeof(range), "-%u", HTTP_TAIL_SIZE);
+
+    http_sink_t sink = {hctx->tail, 0, HTTP_TAIL_SIZE};
+    int64_t got = http_fetch(hctx, range, &sink, 1);
+    if (got < 0) {
+        free(hctx->tail);
+        hctx->tail = NULL;
+        return ZIPRAND_ERR_IO;
+    }
+
+    /* a 200 on a file smaller than the tail window delivers the whole
+     * body without Content-Range; the received length is the size */
+    if (hctx->size < 0)
+        hctx->size = got;
+
+    hctx->tail_len = (size_t)got;
+    hctx->tail_off = (uint64_t)hctx->size - hctx->tail_len;
+    return ZIPRAND_OK;
+}
+
+static int64_t http_read(void* ctx, uint64_t offset, void* buffer, size_t size)
+{
+    http_io_ctx_t* hctx = ctx;
+
+    if (!hctx->tail && http_load_tail(hctx) != ZIPRAND_OK)
+        return -1;
+    if (offset >= (uint64_t)hctx->size)
+        return 0;
+    if (size > (uint64_t)hctx->size - offset)
+        size = (size_t)((uint64_t)hctx->size - offset);
+
+    /* tail cache: covers the EOCD scan and central directory load */
+    if (offset >= hctx->tail_off && offset + size <= hctx->tail_off + hctx->tail_len) {
+        memcpy(buffer, hctx->tail + (offset - hctx->tail_off), size);
+        return (int64_t)size;
+    }
+
+    /* coalescing window for small mid-archive reads */
+    if (hctx->window && offset >= hctx->window_off &&
+        offset + size <= hctx->window_off + hctx->window_len) {
+        memcpy(buffer, hctx->window + (offset - hctx->window_off), size);
+        return (int64_t)size;
+    }
+
+    if (size < HTTP_COALESCE_SIZE) {
+        if (!hctx->window) {
+            hctx->window = malloc(HTTP_COALESCE_SIZE);
+            if (!hctx->window)
+                return -1;
+        }
+        size_t want = HTTP_COALESCE_SIZE;
+        if (want > (uint64_t)hctx->size - offset)
+            want = (size_t)((uint64_t)hctx->size - offset);
+
+        char range[64];
+        snprintf(range, sizeof(range), "%llu-%llu", (unsigned long long)offset,
+                 (unsigned long long)(offset + want - 1));
+        http_sink_t sink = {hctx->window, 0, want};
+        int64_t got = http_fetch(hctx, range, &sink, 0);
+        if (got < (int64_t)size)
+            return -1;
+        hctx->window_off = offset;
+        hctx->window_len = (size_t)got;
+        memcpy(buffer, hctx->window, size);
+        return (int64_t)size;
+    }
+
+    /* large reads go straight through */
+    char range[64];
+    snprintf(range, sizeof(range), "%llu-%llu", (unsigned long long)offset,
+             (unsigned long long)(offset + size - 1));
+    http_sink_t sink = {buffer, 0, size};
+    return http_fetch(hctx, range, &sink, 0);
+}
+
+static int64_t http_size(void* ctx)
+{
+    http_io_ctx_t* hctx = ctx;
+    if (!hctx->tail && http_load_tail(hctx) != ZIPRAND_OK)
+        return -1;
+    return hctx->size;
+}
+
+static void http_close(void* ctx)
+{
+    http_io_ctx_t* hctx = ctx;
+    curl_easy_cleanup(hctx->curl);
+    free(hctx->url);
+    free(hctx->tail);
+    free(hctx->window);
+    free(hctx);
+}
+
+ziprand_io_t* ziprand_io_http(const char* url)
+{
+    if (!url)
+        return NULL;
+
+    http_io_ctx_t* hctx = calloc(1, sizeof(http_io_ctx_t));
+    if (!hctx)
+        return NULL;
+    hctx->size = -1;
+
+    hctx->curl = curl_easy_init();
+    hctx->url = hctx->curl ? strdup(url) : NULL;
+    if (!hctx->curl || !hctx->url) {
+        if (hctx->curl)
+            curl_easy_cleanup(hctx->curl);
+        free(hctx->url);
+        free(hctx);
+        return NULL;
+    }
+
+    ziprand_io_t* io = malloc(sizeof(ziprand_io_t));
+    if (!io) {
+        http_close(hctx);
+        return NULL;
+    }
+
+    io->ctx = hctx;
+    io->read = http_read;
+    io->get_size = http_size;
+    io->close = http_close;
+    io->map = NULL;
+    io->readv = NULL;
+    io->submit = NULL;
+    io->reap = NULL;
+    io->advise = NULL;
+
+    return io;
+}
+
+#else /* !ZIPRAND_HAVE_CURL */
+
+ziprand_io_t* ziprand_io_http(const char* url)
+{
+    (void)url;
+    return NULL;
+}
+
+#endif /* ZIPRAND_HAVE_CURL */
@@ -0,0 +1,254 @@
+/* Persistent serialized central-directory index.
+ *
+ * ziprand_index_save writes the parsed entry table - including resolved
+ * data offsets and the name hash index - into a compact flat sidecar file,
+ * fingerprinted by archive size and central directory location.
+ * ziprand_open_with_index rebuilds an archive handle from that sidecar
+ * with one bulk read and a single cheap validation probe against the
+ * archive, skipping the CD parse entirely on reopen.
+ *
+ * All fields are little-endian. Layout:
+ *   header   (64 bytes, see below)
+ *   entries  (entry_count x 48-byte records)
+ *   names    (names_size bytes, NUL-terminated strings)
+ *   buckets  (bucket_count x u32 hash table)
+ */
+#include "ziprand_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define INDEX_MAGIC   0x5849525Au /* "ZRIX" */
+#define INDEX_VERSION 2u
+
+#define INDEX_HEADER_SIZE 64
+#define INDEX_ENTRY_SIZE  48
+
+static void write_u32_le(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_u64_le(uint8_t* p, uint64_t v)
+{
+    write_u32_le(p, (uint32_t)v);
+    write_u32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+ziprand_error_t ziprand_index_save(ziprand_archive_t* archive, const char* path)
+{
+    if (!archive || !path)
+        return ZIPRAND_ERR_INVALID_PARAM;
+
+    /* a lazy archive must be fully materialized before serializing */
+    ziprand_error_t err = ziprand_archive_parse_all(archive);
+    if (err != ZIPRAND_OK)
+        return err;
+
+    uint64_t names_size = 0;
+    for (size_t i = 0; i < archive->entry_count; i++)
+        names_size += strlen(archive->cols.names[i]) + 1;
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+        return ZIPRAND_ERR_IO;
+
+    uint8_t header[INDEX_HEADER_SIZE] = {0};
+    write_u32_le(&header[0], INDEX_MAGIC);
+    write_u32_le(&header[4], INDEX_VERSION);
+    write_u64_le(&header[8], archive->total_size);
+    write_u64_le(&header[16], archive->cd_offset);
+    write_u64_le(&header[24], archive->cd_size);
+    write_u64_le(&header[32], archive->entry_count);
+    write_u64_le(&header[40], names_size);
+    write_u64_le(&header[48], archive->name_index_size);
+    if (fwrite(header, 1, sizeof(header), fp) != sizeof(header))
+        goto io_error;
+
+    uint64_t name_off = 0;
+    for (size_t i = 0; i < archive->entry_count; i++) {
+        uint8_t record[INDEX_ENTRY_SIZE] = {0};
+        write_u64_le(&record[0], name_off);
+        write_u64_le(&record[8], archive->cols.compressed_sizes[i]);
+        write_u64_le(&record[16], archive->cols.uncompressed_sizes[i]);
+        write_u64_le(&record[24], archive->cols.offsets[i]);
+        write_u64_le(&record[32], archive->cols.data_offsets[i]);
+        record[40] = (uint8_t)archive->cols.methods[i];
+        record[41] = (uint8_t)(archive->cols.methods[i] >> 8);
+        write_u32_le(&record[44], archive->cols.crc32s[i]);
+        if (fwrite(record, 1, sizeof(record), fp) != sizeof(record))
+            goto io_error;
+        name_off += strlen(archive->cols.names[i]) + 1;
+    }
+
+    for (size_t i = 0; i < archive->entry_count; i++) {
+        size_t len = strlen(archive->cols.names[i]) + 1;
+        if (fwrite(archive->cols.names[i], 1, len, fp) != len)
+            goto io_error;
+    }
+
+    uint8_t bucket[4];
+    for (size_t i = 0; i < archive->name_index_size; i++) {
+        write_u32_le(bucket, archive->name_index[i]);
+        if (fwrite(bucket, 1, 4, fp) != 4)
+            goto io_error;
+    }
+
+    if (fclose(fp) != 0)
+        return ZIPRAND_ERR_IO;
+    return ZIPRAND_OK;
+
+io_error:
+    fclose(fp);
+    remove(path);
+    return ZIPRAND_ERR_IO;
+}
+
+ziprand_archive_t* ziprand_open_with_index(const ziprand_io_t* io, const char* index_path)
+{
+    if (!io || !io->read || !io->get_size || !index_path)
+        return NULL;
+
+    FILE* fp = fopen(index_path, "rb");
+    if (!fp)
+        return NULL;
+
+    uint8_t header[INDEX_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header)) {
+        fclose(fp);
+        return NULL;
+    }
+
+    if (read_u32_le(&header[0]) != INDEX_MAGIC || read_u32_le(&header[4]) != INDEX_VERSION) {
+        fclose(fp);
+        return NULL;
+    }
+
+    uint64_t total_size = read_u64_le(&header[8]);
+    uint64_t cd_offset = read_u64_le(&header[16]);
+    uint64_t cd_size = read_u64_le(&header[24]);
+    uint64_t entry_count = read_u64_le(&header[32]);
+    uint64_t names_size = read_u64_le(&header[40]);
+    uint64_t bucket_count = read_u64_le(&header[48]);
+
+    if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0) {
+        fclose(fp);
+        return NULL; /* hash table size must be a power of two */
+    }
+
+    /* bound the untrusted counts against the sidecar's own size before
+     * any of them feed an allocation */
+    if (fseek(fp, 0, SEEK_END) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+    long index_size = ftell(fp);
+    if (index_size < (long)INDEX_HEADER_SIZE || fseek(fp, INDEX_HEADER_SIZE, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+    uint64_t body_size = (uint64_t)index_size - INDEX_HEADER_SIZE;
+    if (entry_count > body_size / INDEX_ENTRY_SIZE || names_size > body_size ||
+        bucket_count > body_size / 4 ||
+        entry_count * INDEX_ENTRY_SIZE + names_size + bucket_count * 4 > body_size) {
+        fclose(fp);
+        return NULL;
+    }
+
+    ziprand_archive_t* archive = calloc(1, sizeof(ziprand_archive_t));
+    if (!archive) {
+        fclose(fp);
+        return NULL;
+    }
+    archive->io = *io;
+
+    /* validate the sidecar against the live archive: size must match and
+     * the recorded CD offset must still point at a CD record */
+    int64_t size = archive->io.get_size(archive->io.ctx);
+    if (size < 0 || (uint64_t)size != total_size)
+        goto fail;
+
+    uint8_t sig[4];
+    if (ziprand_archive_read(archive, cd_offset, sig, 4) != 4 ||
+        (entry_count > 0 && read_u32_le(sig) != CENTRAL_DIR_SIGNATURE))
+        goto fail;
+
+    archive->total_size = total_size;
+    archive->cd_offset = cd_offset;
+    archive->cd_size = cd_size;
+
+    archive->entries = calloc(entry_count, sizeof(ziprand_entry_t));
+    if (!archive->entries)
+        goto fail;
+    if (ziprand_columns_alloc(archive, entry_count) != ZIPRAND_OK)
+        goto fail;
+
+    uint8_t* records = malloc(entry_count * INDEX_ENTRY_SIZE);
+    char* names = arena_alloc(&archive->arena, names_size ? names_size : 1);
+    archive->name_index = malloc(bucket_count * sizeof(uint32_t));
+    if (!records || !names || !archive->name_index) {
+        free(records);
+        goto fail;
+    }
+
+    if (fread(records, 1, entry_count * INDEX_ENTRY_SIZE, fp) != entry_count * INDEX_ENTRY_SIZE ||
+        fread(names, 1, names_size, fp) != names_size ||
+        fread(archive->name_index, 4, bucket_count, fp) != bucket_count) {
+        free(records);
+        goto fail;
+    }
+    fclose(fp);
+    fp = NULL;
+
+    if (names_size > 0 && names[names_size - 1] != '\0') {
+        free(records);
+        goto fail;
+    }
+
+    for (uint64_t i = 0; i < entry_count; i++) {
+        const uint8_t* record = records + i * INDEX_ENTRY_SIZE;
+        uint64_t name_off = read_u64_le(&record[0]);
+        /* every record needs a name, so names_size == 0 with entries
+         * present is rejected here too */
+        if (name_off >= names_size) {
+            free(records);
+            goto fail;
+        }
+        archive->cols.names[i] = names + name_off;
+        archive->cols.compressed_sizes[i] = read_u64_le(&record[8]);
+        archive->cols.uncompressed_sizes[i] = read_u64_le(&record[16]);
+        archive->cols.offsets[i] = read_u64_le(&record[24]);
+        archive->cols.data_offsets[i] = read_u64_le(&record[32]);
+        archive->cols.methods[i] = read_u16_le(&record[40]);
+        archive->cols.crc32s[i] = read_u32_le(&record[44]);
+    }
+    free(records);
+
+    /* bucket values are stored little-endian; fix up in place, rejecting
+     * anything that would index past the entry table */
+    for (uint64_t i = 0; i < bucket_count; i++) {
+        uint32_t slot = read_u32_le((const uint8_t*)&archive->name_index[i]);
+        if (slot != NAME_INDEX_EMPTY && slot >= entry_count)
+            goto fail;
+        archive->name_index[i] = slot;
+    }
+
+    archive->entry_count = entry_count;
+    archive->parsed_count = entry_count;
+    archive->name_index_size = bucket_count;
+
+    return archive;
+
+fail:
+    if (fp)
+        fclose(fp);
+    arena_destroy(&archive->arena);
+    free(archive->name_index);
+    free(archive->cols.names);
+    free(archive->entries);
+    free(archive);
+    return NULL;
+}
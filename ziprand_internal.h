@@ -0,0 +1,236 @@
+#ifndef ZIPRAND_INTERNAL_H
+#define ZIPRAND_INTERNAL_H
+
+#include "ziprand.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/* ZIP signatures */
+#define EOCD_SIGNATURE               0x06054b50
+#define ZIP64_EOCD_SIGNATURE         0x06064b50
+#define ZIP64_EOCD_LOCATOR_SIGNATURE 0x07064b50
+#define CENTRAL_DIR_SIGNATURE        0x02014b50
+#define LOCAL_HEADER_SIGNATURE       0x04034b50
+
+/* empty-slot marker in the name hash index */
+#define NAME_INDEX_EMPTY 0xFFFFFFFFu
+
+/* little-endian field readers */
+static inline uint16_t read_u16_le(const uint8_t* p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint32_t read_u32_le(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t read_u64_le(const uint8_t* p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+           ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/* growable bump arena backing per-archive metadata (entry names). All
+ * allocations live until ziprand_close, so teardown is a walk over a
+ * handful of blocks instead of millions of tiny frees. */
+typedef struct arena_block {
+    struct arena_block* next;
+    size_t used;
+    size_t size;
+    uint8_t data[];
+} arena_block_t;
+
+typedef struct {
+    arena_block_t* head;
+} arena_t;
+
+#define ARENA_BLOCK_SIZE (256u << 10)
+
+static inline void* arena_alloc(arena_t* arena, size_t size)
+{
+    size = (size + 7) & ~(size_t)7; /* keep allocations 8-byte aligned */
+
+    if (!arena->head || arena->head->used + size > arena->head->size) {
+        size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        arena_block_t* block = malloc(sizeof(arena_block_t) + block_size);
+        if (!block)
+            return NULL;
+        block->next = arena->head;
+        block->used = 0;
+        block->size = block_size;
+        arena->head = block;
+    }
+
+    void* ptr = arena->head->data + arena->head->used;
+    arena->head->used += size;
+    return ptr;
+}
+
+/* move all blocks of src into dst (src becomes empty); used to adopt
+ * per-worker arenas after parallel parsing */
+static inline void arena_splice(arena_t* dst, arena_t* src)
+{
+    arena_block_t* block = src->head;
+    if (!block)
+        return;
+    while (block->next)
+        block = block->next;
+    block->next = dst->head;
+    dst->head = src->head;
+    src->head = NULL;
+}
+
+static inline void arena_destroy(arena_t* arena)
+{
+    arena_block_t* block = arena->head;
+    while (block) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
+
+/* incremental CRC-32, ISO-HDLC polynomial (ziprand_crc.c); pass 0 as the
+ * initial crc */
+uint32_t ziprand_crc32(uint32_t crc, const void* data, size_t len);
+
+/* vectorized signature scanning (ziprand_scan.c): first / last position in
+ * [buf, buf+len-4] where the little-endian u32 sig starts, or NULL */
+const uint8_t* ziprand_scan_sig(const uint8_t* buf, size_t len, uint32_t sig);
+const uint8_t* ziprand_scan_sig_rev(const uint8_t* buf, size_t len, uint32_t sig);
+
+/* optional block cache (ziprand_cache.c) */
+typedef struct ziprand_cache ziprand_cache_t;
+
+#define ZIPRAND_CACHE_DEFAULT_BLOCK (64u << 10)
+
+ziprand_cache_t* ziprand_cache_new(size_t block_size, size_t block_count);
+void ziprand_cache_free(ziprand_cache_t* cache);
+int64_t ziprand_cache_read(ziprand_cache_t* cache,
+                           const ziprand_io_t* io,
+                           uint64_t total_size,
+                           uint64_t offset,
+                           void* buffer,
+                           size_t size);
+
+/* Columnar entry storage: the authoritative copy of the entry table.
+ * Parallel arrays keep full-archive scans over one hot field (names,
+ * sizes, offsets) dense in cache instead of striding 48-byte structs.
+ * The ziprand_entry_t structs handed out by the public API are views
+ * filled from these columns on demand. All arrays live in one allocation
+ * starting at names. */
+typedef struct {
+    char** names;
+    uint64_t* compressed_sizes;
+    uint64_t* uncompressed_sizes;
+    uint64_t* offsets;
+    uint64_t* data_offsets;
+    uint16_t* methods;
+    uint32_t* crc32s;
+} ziprand_columns_t;
+
+/* relaxed-atomic I/O counters; always on since an uncontended relaxed
+ * fetch-add is far cheaper than the reads being counted */
+typedef struct {
+    atomic_uint_fast64_t reads;
+    atomic_uint_fast64_t bytes_read;
+    atomic_uint_fast64_t reads_by_bucket[ZIPRAND_STATS_BUCKETS];
+    atomic_uint_fast64_t lookups;
+    atomic_uint_fast64_t lookups_found;
+    atomic_uint_fast64_t cd_parse_ns;
+    atomic_uint_fast64_t eocd_scan_bytes;
+} ziprand_stats_atomic_t;
+
+/* main archive handle */
+struct ziprand_archive {
+    ziprand_io_t io;
+    ziprand_cache_t* cache; /* optional block cache, NULL when disabled */
+    ziprand_columns_t cols; /* authoritative columnar entry table */
+    ziprand_entry_t* entries; /* lazily-filled public views over cols */
+    size_t entry_count;
+    uint64_t total_size;
+    arena_t arena; /* backs entry names and other per-archive metadata */
+    uint32_t* name_index; /* open-addressing hash table of entry indices */
+    size_t name_index_size; /* bucket count, power of two */
+    uint32_t* name_order; /* entry indices sorted by name; built on first prefix query */
+
+    int verify; /* verify each entry's CRC-32 before handing out a handle */
+    int cached; /* owned by the process-level cache (ziprand_cached.c) */
+
+    ziprand_stats_atomic_t stats;
+    ziprand_trace_fn trace; /* optional per-read trace hook, NULL when unset */
+    void* trace_user;
+
+    /* lazy-mode state: CD records are parsed incrementally on demand */
+    int lazy;
+    int cd_error; /* sticky flag: incremental parse hit an error */
+    uint64_t cd_offset; /* absolute offset of the central directory */
+    uint64_t cd_size; /* total size of the central directory */
+    uint64_t cd_consumed; /* CD bytes parsed so far */
+    size_t parsed_count; /* entries materialized so far */
+    uint8_t* cd_window; /* sliding slab over the unparsed CD tail */
+    size_t cd_window_len;
+    size_t cd_window_pos;
+};
+
+/* file reader handle */
+struct ziprand_file {
+    ziprand_archive_t* archive;
+    const ziprand_entry_t* entry;
+    uint64_t position;
+    void* inflate; /* deflate random-access state, NULL otherwise */
+    void* zstd; /* seekable-zstd random-access state, NULL otherwise */
+    int owned; /* 1 when heap-allocated by ziprand_fopen, 0 for caller storage */
+
+    /* readahead state, used only by handles from ziprand_fopen_buffered */
+    uint8_t* rbuf; /* readahead buffer, NULL for unbuffered handles */
+    size_t rbuf_cap; /* buffer capacity; ceiling for readahead growth */
+    uint64_t rbuf_off; /* entry offset of the buffered window */
+    size_t rbuf_len; /* valid bytes in the window */
+    size_t readahead; /* next fill size; doubles while reads stay sequential */
+};
+
+/* allocate the columnar entry store, zero-filled, as one block owned by
+ * cols.names (used by ziprand.c and the sidecar-index loader) */
+ziprand_error_t ziprand_columns_alloc(ziprand_archive_t* archive, size_t count);
+
+/* archive-level read: routes through the block cache when one is attached */
+int64_t
+ziprand_archive_read(ziprand_archive_t* archive, uint64_t offset, void* buffer, size_t size);
+
+/* materialize every CD record of a lazy archive (used before serializing) */
+ziprand_error_t ziprand_archive_parse_all(ziprand_archive_t* archive);
+
+/* allocate the name hash index and insert the first count entries (used
+ * by the recovery sweep, which fills cols without the CD parse path) */
+ziprand_error_t ziprand_name_index_build(ziprand_archive_t* archive, size_t count);
+
+/* drop one reference on a cached archive (ziprand_cached.c); returns the
+ * remaining count - at zero ziprand_close continues with the teardown */
+int ziprand_cached_release(ziprand_archive_t* archive);
+
+#ifdef ZIPRAND_HAVE_ZSTD
+/* random access into seekable-zstd entries (ziprand_zstd.c) */
+typedef struct ziprand_zstd ziprand_zstd_t;
+
+ziprand_zstd_t* ziprand_zstd_new(ziprand_archive_t* archive, const ziprand_entry_t* entry);
+int64_t ziprand_zstd_read_at(ziprand_zstd_t* zf, uint64_t offset, void* buffer, size_t size);
+void ziprand_zstd_free(ziprand_zstd_t* zf);
+#endif
+
+#ifdef ZIPRAND_HAVE_ZLIB
+/* random access into DEFLATE entries (ziprand_deflate.c) */
+typedef struct ziprand_inflate ziprand_inflate_t;
+
+ziprand_inflate_t* ziprand_inflate_new(ziprand_archive_t* archive, const ziprand_entry_t* entry);
+int64_t
+ziprand_inflate_read_at(ziprand_inflate_t* zf, uint64_t offset, void* buffer, size_t size);
+void ziprand_inflate_free(ziprand_inflate_t* zf);
+#endif
+
+#endif /* ZIPRAND_INTERNAL_H */
@@ -0,0 +1,317 @@
+/* Damaged-archive recovery.
+ *
+ * When the EOCD or central directory is unusable (truncated upload,
+ * overwritten tail), ziprand_open_recover rebuilds the entry table from
+ * the local file headers instead: the whole file is swept for
+ * LOCAL_HEADER_SIGNATURE with the same vectorized kernels find_eocd
+ * uses, split into per-thread regions so a large archive is recovered at
+ * streaming I/O speed. Every candidate header is validated before it
+ * becomes an entry, and the surviving records are stitched together in
+ * file order into an ordinary archive handle.
+ *
+ * Entries written with a data descriptor (flag bit 3) carry zero sizes
+ * and CRC in their local header; they are recovered with those zeros and
+ * cannot be read back, but their names and offsets still come out.
+ */
+#include "ziprand_internal.h"
+
+#include <string.h>
+
+/* per-worker streaming window over the file */
+#define RECOVER_CHUNK (8u << 20)
+
+/* parallel sweep kicks in once every worker gets at least this much file */
+#define RECOVER_MIN_REGION (16u << 20)
+#define RECOVER_MAX_THREADS 64
+
+typedef struct {
+    const ziprand_io_t* io;
+    uint64_t total_size;
+    uint64_t start; /* first byte of this worker's region */
+    uint64_t end;   /* headers starting before end belong to this worker */
+    ziprand_entry_t* entries;
+    size_t count;
+    size_t cap;
+    arena_t arena;
+    int error;
+} recover_worker_t;
+
+static int recover_read_fully(const ziprand_io_t* io, uint64_t offset, uint8_t* buf, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+        int64_t got = io->read(io->ctx, offset + done, buf + done, size - done);
+        if (got <= 0)
+            return -1;
+        done += (size_t)got;
+    }
+    return 0;
+}
+
+/* a signature match in arbitrary bytes is a 2^-32 event; light checks on
+ * the header fields weed out the stragglers without rejecting unusual
+ * but legal entries */
+static int recover_header_plausible(const uint8_t* header, const uint8_t* name, size_t name_len)
+{
+    if (name_len == 0)
+        return 0;
+    for (size_t i = 0; i < name_len; i++) {
+        if (name[i] == '\0' || name[i] < 0x09)
+            return 0;
+    }
+    /* version-needed-to-extract: anything the spec has ever assigned
+     * fits comfortably under 100 */
+    if (read_u16_le(&header[4]) >= 100)
+        return 0;
+    return 1;
+}
+
+static int recover_append(recover_worker_t* worker,
+                          uint64_t offset,
+                          const uint8_t* header,
+                          const uint8_t* name_bytes,
+                          size_t name_len)
+{
+    if (worker->count == worker->cap) {
+        size_t cap = worker->cap ? worker->cap * 2 : 1024;
+        ziprand_entry_t* entries = realloc(worker->entries, cap * sizeof(ziprand_entry_t));
+        if (!entries)
+            return -1;
+        worker->entries = entries;
+        worker->cap = cap;
+    }
+
+    char* name = arena_alloc(&worker->arena, name_len + 1);
+    if (!name)
+        return -1;
+    memcpy(name, name_bytes, name_len);
+    name[name_len] = '\0';
+
+    ziprand_entry_t* entry = &worker->entries[worker->count++];
+    entry->name = name;
+    entry->compression_method = read_u16_le(&header[8]);
+    entry->crc32 = read_u32_le(&header[14]);
+    entry->compressed_size = read_u32_le(&header[18]);
+    entry->uncompressed_size = read_u32_le(&header[22]);
+    entry->offset = offset;
+    /* the local header is in hand, so unlike the CD path the data offset
+     * is known immediately */
+    entry->data_offset = offset + 30 + name_len + read_u16_le(&header[28]);
+    return 0;
+}
+
+static void* recover_worker_run(void* arg)
+{
+    recover_worker_t* worker = arg;
+
+    uint8_t* buf = malloc(RECOVER_CHUNK);
+    if (!buf) {
+        worker->error = 1;
+        return NULL;
+    }
+
+    uint64_t pos = worker->start;
+    while (pos < worker->end) {
+        size_t want = RECOVER_CHUNK;
+        if (want > worker->total_size - pos)
+            want = (size_t)(worker->total_size - pos);
+        if (recover_read_fully(worker->io, pos, buf, want) != 0) {
+            worker->error = 1;
+            break;
+        }
+
+        /* scan a few bytes past end so a signature starting on the last
+         * region bytes is still found; ownership is decided below */
+        size_t scan_len = want;
+        if (pos + scan_len > worker->end + 3)
+            scan_len = (size_t)(worker->end + 3 - pos);
+
+        /* refill with a 3-byte overlap so signatures straddling the
+         * window boundary are seen by the next iteration */
+        uint64_t next_pos = pos + (want > 3 ? want - 3 : want);
+
+        size_t off = 0;
+        while (scan_len - off >= 4) {
+            const uint8_t* hit =
+                ziprand_scan_sig(buf + off, scan_len - off, LOCAL_HEADER_SIGNATURE);
+            if (!hit)
+                break;
+            size_t h = (size_t)(hit - buf);
+            if (pos + h >= worker->end)
+                break; /* next worker's record */
+
+            if (h + 30 > want) {
+                /* header truncated by the window: refill starting here,
+                 * unless it is truncated by the file itself */
+                if (pos + h + 30 <= worker->total_size)
+                    next_pos = pos + h;
+                off = h + 4;
+                break;
+            }
+
+            size_t name_len = read_u16_le(&buf[h + 26]);
+            if (h + 30 + name_len > want) {
+                if (pos + h + 30 + name_len <= worker->total_size) {
+                    next_pos = pos + h;
+                    off = h + 4;
+                    break;
+                }
+                off = h + 4; /* name runs past EOF: not a real header */
+                continue;
+            }
+
+            if (recover_header_plausible(&buf[h], &buf[h + 30], name_len) &&
+                recover_append(worker, pos + h, &buf[h], &buf[h + 30], name_len) != 0) {
+                worker->error = 1;
+                free(buf);
+                return NULL;
+            }
+            /* keep sweeping byte-by-byte past the signature: header sizes
+             * are untrusted, so no record is ever skipped over */
+            off = h + 4;
+        }
+
+        if (next_pos <= pos)
+            break; /* end of file reached within this window */
+        pos = next_pos;
+    }
+
+    free(buf);
+    return NULL;
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+#include <unistd.h>
+
+static int recover_resolve_threads(uint64_t total_size)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int nthreads = cores > 0 ? (int)cores : 1;
+
+    if (nthreads > RECOVER_MAX_THREADS)
+        nthreads = RECOVER_MAX_THREADS;
+    while (nthreads > 1 && total_size / (uint64_t)nthreads < RECOVER_MIN_REGION)
+        nthreads--;
+    return nthreads;
+}
+
+#endif /* !_WIN32 */
+
+ziprand_archive_t* ziprand_open_recover(const ziprand_io_t* io)
+{
+    if (!io || !io->read || !io->get_size)
+        return NULL;
+
+    int64_t size = io->get_size(io->ctx);
+    if (size <= 0)
+        return NULL;
+
+    int nthreads = 1;
+#ifndef _WIN32
+    nthreads = recover_resolve_threads((uint64_t)size);
+#endif
+
+    recover_worker_t* workers = calloc((size_t)nthreads, sizeof(recover_worker_t));
+    if (!workers)
+        return NULL;
+
+    uint64_t region = (uint64_t)size / (uint64_t)nthreads;
+    for (int t = 0; t < nthreads; t++) {
+        workers[t].io = io;
+        workers[t].total_size = (uint64_t)size;
+        workers[t].start = region * (uint64_t)t;
+        workers[t].end = t == nthreads - 1 ? (uint64_t)size : region * (uint64_t)(t + 1);
+    }
+
+#ifndef _WIN32
+    if (nthreads > 1) {
+        pthread_t* tids = malloc((size_t)(nthreads - 1) * sizeof(pthread_t));
+        int spawned = 0;
+        if (tids) {
+            for (; spawned < nthreads - 1; spawned++) {
+                if (pthread_create(&tids[spawned], NULL, recover_worker_run, &workers[spawned + 1]) !=
+                    0)
+                    break;
+            }
+        }
+        /* unspawned regions (or all of them, if tids failed) run here */
+        recover_worker_run(&workers[0]);
+        for (int t = spawned + 1; t < nthreads; t++)
+            recover_worker_run(&workers[t]);
+        for (int t = 0; t < spawned; t++)
+            pthread_join(tids[t], NULL);
+        free(tids);
+    } else
+#endif
+    {
+        recover_worker_run(&workers[0]);
+    }
+
+    size_t total = 0;
+    int failed = 0;
+    for (int t = 0; t < nthreads; t++) {
+        if (workers[t].error)
+            failed = 1;
+        total += workers[t].count;
+    }
+    if (failed || total == 0)
+        goto fail;
+
+    ziprand_archive_t* archive = calloc(1, sizeof(ziprand_archive_t));
+    if (!archive)
+        goto fail;
+
+    archive->io = *io;
+    archive->total_size = (uint64_t)size;
+    archive->entry_count = total;
+    archive->parsed_count = total;
+
+    archive->entries = calloc(total, sizeof(ziprand_entry_t));
+    if (!archive->entries || ziprand_columns_alloc(archive, total) != ZIPRAND_OK)
+        goto fail_archive;
+
+    /* regions are contiguous and each worker appends in order, so plain
+     * concatenation yields the entry table in file-offset order */
+    size_t out = 0;
+    for (int t = 0; t < nthreads; t++) {
+        for (size_t k = 0; k < workers[t].count; k++) {
+            const ziprand_entry_t* entry = &workers[t].entries[k];
+            archive->cols.names[out] = (char*)entry->name;
+            archive->cols.compressed_sizes[out] = entry->compressed_size;
+            archive->cols.uncompressed_sizes[out] = entry->uncompressed_size;
+            archive->cols.offsets[out] = entry->offset;
+            archive->cols.data_offsets[out] = entry->data_offset;
+            archive->cols.methods[out] = entry->compression_method;
+            archive->cols.crc32s[out] = entry->crc32;
+            out++;
+        }
+        arena_splice(&archive->arena, &workers[t].arena);
+        free(workers[t].entries);
+    }
+    free(workers);
+
+    if (ziprand_name_index_build(archive, total) != ZIPRAND_OK) {
+        workers = NULL; /* worker arenas already spliced into the archive */
+        goto fail_archive;
+    }
+    return archive;
+
+fail_archive:
+    /* partially built handle: tear it down without touching the caller's
+     * io, mirroring the open path */
+    arena_destroy(&archive->arena);
+    free(archive->name_index);
+    free(archive->cols.names);
+    free(archive->entries);
+    free(archive);
+
+fail:
+    for (int t = 0; workers && t < nthreads; t++) {
+        arena_destroy(&workers[t].arena);
+        free(workers[t].entries);
+    }
+    free(workers);
+    return NULL;
+}
@@ -0,0 +1,234 @@
+/* Vectorized ZIP signature scanning.
+ *
+ * Every ZIP record signature starts with 'P' (0x50), so the kernels
+ * compare a whole vector against that lead byte and only fall back to a
+ * scalar 32-bit load on candidate positions: the hot path is one compare
+ * plus one movemask per 16 or 32 bytes. On x86-64 an AVX2 kernel is
+ * selected at runtime via __builtin_cpu_supports with SSE2 as the
+ * baseline; AArch64 compiles the NEON kernel unconditionally; everything
+ * else uses a memchr-driven portable loop (libc memchr is itself
+ * vectorized on most targets).
+ */
+#include "ziprand_internal.h"
+
+#include <string.h>
+
+/* the x86 kernels use __builtin_cpu_supports and target attributes, so
+ * they need a GNU-compatible compiler; MSVC takes the portable path */
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__GNUC__)
+#define ZIPRAND_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define ZIPRAND_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* portable kernels; also the tail handler for the vector kernels */
+
+static const uint8_t* scan_fwd_scalar(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    const uint8_t lead = (uint8_t)sig;
+    const uint8_t* p = buf;
+    const uint8_t* end = buf + len;
+
+    while (end - p >= 4) {
+        p = memchr(p, lead, (size_t)(end - p) - 3);
+        if (!p)
+            return NULL;
+        if (read_u32_le(p) == sig)
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+static const uint8_t* scan_rev_scalar(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    const uint8_t lead = (uint8_t)sig;
+
+    if (len < 4)
+        return NULL;
+    for (size_t i = len - 4;; i--) {
+        if (buf[i] == lead && read_u32_le(buf + i) == sig)
+            return buf + i;
+        if (i == 0)
+            break;
+    }
+    return NULL;
+}
+
+#ifdef ZIPRAND_SCAN_X86
+
+static const uint8_t* scan_fwd_sse2(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    const __m128i lead = _mm_set1_epi8((char)(uint8_t)sig);
+    size_t i = 0;
+
+    while (i + 16 + 3 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(buf + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lead));
+        while (mask) {
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (i + bit + 4 <= len && read_u32_le(buf + i + bit) == sig)
+                return buf + i + bit;
+            mask &= mask - 1;
+        }
+        i += 16;
+    }
+    return scan_fwd_scalar(buf + i, len - i, sig);
+}
+
+__attribute__((target("avx2"))) static const uint8_t*
+scan_fwd_avx2(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    const __m256i lead = _mm256_set1_epi8((char)(uint8_t)sig);
+    size_t i = 0;
+
+    while (i + 32 + 3 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(buf + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lead));
+        while (mask) {
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (i + bit + 4 <= len && read_u32_le(buf + i + bit) == sig)
+                return buf + i + bit;
+            mask &= mask - 1;
+        }
+        i += 32;
+    }
+    return scan_fwd_scalar(buf + i, len - i, sig);
+}
+
+static const uint8_t* scan_rev_sse2(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    if (len < 4)
+        return NULL;
+
+    const __m128i lead = _mm_set1_epi8((char)(uint8_t)sig);
+    size_t pos = len - 3; /* one past the last valid signature start */
+
+    while (pos >= 16) {
+        size_t base = pos - 16;
+        __m128i v = _mm_loadu_si128((const __m128i*)(buf + base));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lead));
+        while (mask) {
+            unsigned bit = 31u - (unsigned)__builtin_clz(mask);
+            if (read_u32_le(buf + base + bit) == sig)
+                return buf + base + bit;
+            mask &= ~(1u << bit);
+        }
+        pos = base;
+    }
+    return scan_rev_scalar(buf, pos + 3, sig);
+}
+
+__attribute__((target("avx2"))) static const uint8_t*
+scan_rev_avx2(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    if (len < 4)
+        return NULL;
+
+    const __m256i lead = _mm256_set1_epi8((char)(uint8_t)sig);
+    size_t pos = len - 3;
+
+    while (pos >= 32) {
+        size_t base = pos - 32;
+        __m256i v = _mm256_loadu_si256((const __m256i*)(buf + base));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lead));
+        while (mask) {
+            unsigned bit = 31u - (unsigned)__builtin_clz(mask);
+            if (read_u32_le(buf + base + bit) == sig)
+                return buf + base + bit;
+            mask &= ~(1u << bit);
+        }
+        pos = base;
+    }
+    return scan_rev_scalar(buf, pos + 3, sig);
+}
+
+static int scan_have_avx2(void)
+{
+    static int have = -1;
+    if (have < 0)
+        have = __builtin_cpu_supports("avx2");
+    return have;
+}
+
+#endif /* ZIPRAND_SCAN_X86 */
+
+#ifdef ZIPRAND_SCAN_NEON
+
+/* narrow the byte-wise compare result to 4 bits per lane so a single
+ * 64-bit scalar carries the whole 16-byte match mask */
+static inline uint64_t scan_neon_mask(uint8x16_t eq)
+{
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static const uint8_t* scan_fwd_neon(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    const uint8x16_t lead = vdupq_n_u8((uint8_t)sig);
+    size_t i = 0;
+
+    while (i + 16 + 3 <= len) {
+        uint64_t mask = scan_neon_mask(vceqq_u8(vld1q_u8(buf + i), lead));
+        while (mask) {
+            unsigned bit = (unsigned)__builtin_ctzll(mask) >> 2;
+            if (i + bit + 4 <= len && read_u32_le(buf + i + bit) == sig)
+                return buf + i + bit;
+            mask &= ~(0xFull << (bit * 4));
+        }
+        i += 16;
+    }
+    return scan_fwd_scalar(buf + i, len - i, sig);
+}
+
+static const uint8_t* scan_rev_neon(const uint8_t* buf, size_t len, uint32_t sig)
+{
+    if (len < 4)
+        return NULL;
+
+    const uint8x16_t lead = vdupq_n_u8((uint8_t)sig);
+    size_t pos = len - 3;
+
+    while (pos >= 16) {
+        size_t base = pos - 16;
+        uint64_t mask = scan_neon_mask(vceqq_u8(vld1q_u8(buf + base), lead));
+        while (mask) {
+            unsigned bit = (63u - (unsigned)__builtin_clzll(mask)) >> 2;
+            if (read_u32_le(buf + base + bit) == sig)
+                return buf + base + bit;
+            mask &= ~(0xFull << (bit * 4));
+        }
+        pos = base;
+    }
+    return scan_rev_scalar(buf, pos + 3, sig);
+}
+
+#endif /* ZIPRAND_SCAN_NEON */
+
+const uint8_t* ziprand_scan_sig(const uint8_t* buf, size_t len, uint32_t sig)
+{
+#if defined(ZIPRAND_SCAN_X86)
+    if (scan_have_avx2())
+        return scan_fwd_avx2(buf, len, sig);
+    return scan_fwd_sse2(buf, len, sig);
+#elif defined(ZIPRAND_SCAN_NEON)
+    return scan_fwd_neon(buf, len, sig);
+#else
+    return scan_fwd_scalar(buf, len, sig);
+#endif
+}
+
+const uint8_t* ziprand_scan_sig_rev(const uint8_t* buf, size_t len, uint32_t sig)
+{
+#if defined(ZIPRAND_SCAN_X86)
+    if (scan_have_avx2())
+        return scan_rev_avx2(buf, len, sig);
+    return scan_rev_sse2(buf, len, sig);
+#elif defined(ZIPRAND_SCAN_NEON)
+    return scan_rev_neon(buf, len, sig);
+#else
+    return scan_rev_scalar(buf, len, sig);
+#endif
+}
@@ -0,0 +1,234 @@
+/* io_uring I/O backend.
+ *
+ * The synchronous read callback is a thin wrapper over the same ring the
+ * async path uses: it submits one SQE and drains completions (dispatching
+ * any async callbacks it encounters) until its own arrives. A single
+ * thread can therefore keep hundreds of reads in flight with
+ * ziprand_fread_async()/ziprand_reap() while still using the plain API.
+ *
+ * One ring is driven from one thread at a time; share an archive across
+ * threads with the file or mmap backends instead.
+ */
+#include "ziprand_internal.h"
+
+#ifdef ZIPRAND_HAVE_LIBURING
+
+#include <errno.h>
+#include <fcntl.h>
+#include <liburing.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define URING_QUEUE_DEPTH 256
+
+typedef struct {
+    int fd;
+    struct io_uring ring;
+} uring_io_ctx_t;
+
+/* one in-flight read; async requests are heap-allocated and freed on
+ * dispatch, synchronous waiters live on the caller's stack with cb NULL */
+typedef struct {
+    ziprand_read_cb cb;
+    void* user;
+    int done;
+    int64_t result;
+} uring_req_t;
+
+static void uring_dispatch(struct io_uring_cqe* cqe)
+{
+    uring_req_t* req = io_uring_cqe_get_data(cqe);
+    int64_t result = cqe->res < 0 ? -1 : cqe->res;
+
+    if (!req)
+        return; /* neutralized SQE (see uring_read) */
+    if (req->cb) {
+        req->cb(req->user, result);
+        free(req);
+    } else {
+        req->result = result;
+        req->done = 1;
+    }
+}
+
+/* grab an SQE, flushing the ring if the submission queue is full */
+static struct io_uring_sqe* uring_get_sqe(uring_io_ctx_t* uctx)
+{
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&uctx->ring);
+    if (!sqe) {
+        io_uring_submit(&uctx->ring);
+        sqe = io_uring_get_sqe(&uctx->ring);
+    }
+    return sqe;
+}
+
+static int64_t uring_read(void* ctx, uint64_t offset, void* buffer, size_t size)
+{
+    uring_io_ctx_t* uctx = ctx;
+
+    uring_req_t req = {0};
+    struct io_uring_sqe* sqe = uring_get_sqe(uctx);
+    if (!sqe)
+        return -1;
+    io_uring_prep_read(sqe, uctx->fd, buffer, size, offset);
+    io_uring_sqe_set_data(sqe, &req);
+
+    /* req lives on this stack frame and the kernel holds a pointer to it
+     * once the SQE is consumed; from then on this function must not
+     * return until the completion is reaped, or a later drain would
+     * dispatch into a dead frame */
+    while (!req.done) {
+        int ret = io_uring_submit_and_wait(&uctx->ring, 1);
+        if (ret < 0 && ret != -EINTR && io_uring_sq_ready(&uctx->ring) > 0) {
+            /* our SQE (queued last) never reached the kernel: turn it
+             * into a no-op so a later submit cannot complete into this
+             * frame, and fail the read */
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data(sqe, NULL);
+            return -1;
+        }
+        /* on other errors the read is already in flight: keep draining
+         * until its completion arrives */
+
+        struct io_uring_cqe* cqe;
+        while (io_uring_peek_cqe(&uctx->ring, &cqe) == 0) {
+            uring_dispatch(cqe);
+            io_uring_cqe_seen(&uctx->ring, cqe);
+        }
+    }
+
+    return req.result;
+}
+
+static int uring_submit(void* ctx,
+                        uint64_t offset,
+                        void* buffer,
+                        size_t size,
+                        ziprand_read_cb cb,
+                        void* user)
+{
+    uring_io_ctx_t* uctx = ctx;
+
+    uring_req_t* req = malloc(sizeof(uring_req_t));
+    if (!req)
+        return -1;
+    req->cb = cb;
+    req->user = user;
+    req->done = 0;
+    req->result = 0;
+
+    struct io_uring_sqe* sqe = uring_get_sqe(uctx);
+    if (!sqe) {
+        free(req);
+        return -1;
+    }
+    io_uring_prep_read(sqe, uctx->fd, buffer, size, offset);
+    io_uring_sqe_set_data(sqe, req);
+
+    if (io_uring_submit(&uctx->ring) < 0) {
+        if (io_uring_sq_ready(&uctx->ring) > 0) {
+            /* our SQE (queued last) never reached the kernel: turn it
+             * into a no-op so a later submit cannot read into a buffer
+             * the caller may recycle after this failure */
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data(sqe, NULL);
+            free(req);
+            return -1;
+        }
+        /* consumed despite the error: the read is in flight and its
+         * completion (which frees req) will surface through reap */
+    }
+    return 0;
+}
+
+static int uring_reap(void* ctx, int min_completions)
+{
+    uring_io_ctx_t* uctx = ctx;
+    struct io_uring_cqe* cqe;
+    int reaped = 0;
+
+    while (reaped < min_completions) {
+        if (io_uring_wait_cqe(&uctx->ring, &cqe) < 0)
+            return -1;
+        uring_dispatch(cqe);
+        io_uring_cqe_seen(&uctx->ring, cqe);
+        reaped++;
+    }
+
+    while (io_uring_peek_cqe(&uctx->ring, &cqe) == 0) {
+        uring_dispatch(cqe);
+        io_uring_cqe_seen(&uctx->ring, cqe);
+        reaped++;
+    }
+
+    return reaped;
+}
+
+static int64_t uring_size(void* ctx)
+{
+    uring_io_ctx_t* uctx = ctx;
+    struct stat st;
+    if (fstat(uctx->fd, &st) < 0)
+        return -1;
+    return (int64_t)st.st_size;
+}
+
+static void uring_close(void* ctx)
+{
+    uring_io_ctx_t* uctx = ctx;
+    io_uring_queue_exit(&uctx->ring);
+    if (uctx->fd >= 0)
+        close(uctx->fd);
+    free(uctx);
+}
+
+ziprand_io_t* ziprand_io_uring(const char* path)
+{
+    if (!path)
+        return NULL;
+
+    uring_io_ctx_t* uctx = malloc(sizeof(uring_io_ctx_t));
+    if (!uctx)
+        return NULL;
+
+    uctx->fd = open(path, O_RDONLY);
+    if (uctx->fd < 0) {
+        free(uctx);
+        return NULL;
+    }
+
+    if (io_uring_queue_init(URING_QUEUE_DEPTH, &uctx->ring, 0) < 0) {
+        close(uctx->fd);
+        free(uctx);
+        return NULL;
+    }
+
+    ziprand_io_t* io = malloc(sizeof(ziprand_io_t));
+    if (!io) {
+        uring_close(uctx);
+        return NULL;
+    }
+
+    io->ctx = uctx;
+    io->read = uring_read;
+    io->get_size = uring_size;
+    io->close = uring_close;
+    io->map = NULL;
+    io->readv = NULL;
+    io->submit = uring_submit;
+    io->reap = uring_reap;
+    io->advise = NULL;
+
+    return io;
+}
+
+#else /* !ZIPRAND_HAVE_LIBURING */
+
+ziprand_io_t* ziprand_io_uring(const char* path)
+{
+    (void)path;
+    return NULL;
+}
+
+#endif /* ZIPRAND_HAVE_LIBURING */
@@ -0,0 +1,216 @@
+/* Random access into zstd (method 93) entries.
+ *
+ * Requires the entry to use zstd's seekable format: the payload is a
+ * series of independent zstd frames followed by a skippable frame whose
+ * content is a seek table mapping frame boundaries to uncompressed
+ * offsets. ziprand_fread_at binary-searches the table and decompresses
+ * only the frames covering the requested range; the most recently
+ * decompressed frame is kept so sequential reads within one frame cost
+ * one decompression, not one per call. Entries without a seek table are
+ * rejected at open, since they would only allow whole-entry streaming.
+ *
+ * Like ziprand_file_t itself, one handle must not be used from multiple
+ * threads concurrently.
+ */
+#include "ziprand_internal.h"
+
+#include <string.h>
+#include <zstd.h>
+
+/* seekable-format magic numbers */
+#define ZSTD_SEEK_TABLE_FRAME_MAGIC 0x184D2A5Eu /* skippable frame carrying the table */
+#define ZSTD_SEEKABLE_MAGIC         0x8F92EAB1u /* last 4 bytes of the table */
+
+#define ZSTD_SEEK_FOOTER_SIZE 9 /* frame count + descriptor + magic */
+
+typedef struct {
+    uint64_t c_off; /* cumulative compressed offset of this frame */
+    uint64_t d_off; /* cumulative uncompressed offset of this frame */
+    uint32_t c_size;
+    uint32_t d_size;
+} zstd_frame_t;
+
+struct ziprand_zstd {
+    ziprand_archive_t* archive;
+    const ziprand_entry_t* entry;
+    ZSTD_DCtx* dctx;
+
+    zstd_frame_t* frames; /* sorted by d_off */
+    size_t frame_count;
+
+    /* last decompressed frame, kept hot for clustered reads */
+    uint8_t* cache;
+    size_t cache_cap;
+    size_t cache_frame; /* index into frames, SIZE_MAX when empty */
+};
+
+/* locate and load the seek table from the tail of the entry payload */
+static int zstd_load_table(ziprand_zstd_t* zf)
+{
+    uint64_t c_total = zf->entry->compressed_size;
+    if (c_total < 8 + ZSTD_SEEK_FOOTER_SIZE)
+        return -1;
+
+    uint8_t footer[ZSTD_SEEK_FOOTER_SIZE];
+    if (ziprand_archive_read(zf->archive,
+                             zf->entry->data_offset + c_total - ZSTD_SEEK_FOOTER_SIZE, footer,
+                             ZSTD_SEEK_FOOTER_SIZE) != ZSTD_SEEK_FOOTER_SIZE)
+        return -1;
+    if (read_u32_le(&footer[5]) != ZSTD_SEEKABLE_MAGIC)
+        return -1;
+
+    uint32_t frame_count = read_u32_le(&footer[0]);
+    uint8_t descriptor = footer[4];
+    if (descriptor & 0x7C)
+        return -1; /* reserved bits must be zero */
+    size_t entry_size = (descriptor & 0x80) ? 12 : 8; /* per-frame checksum present? */
+
+    uint64_t content_size = (uint64_t)frame_count * entry_size + ZSTD_SEEK_FOOTER_SIZE;
+    if (frame_count == 0 || content_size + 8 > c_total)
+        return -1;
+    uint64_t table_off = c_total - content_size - 8;
+
+    /* validate the skippable frame header in front of the table */
+    uint8_t header[8];
+    if (ziprand_archive_read(zf->archive, zf->entry->data_offset + table_off, header, 8) != 8)
+        return -1;
+    if (read_u32_le(&header[0]) != ZSTD_SEEK_TABLE_FRAME_MAGIC ||
+        read_u32_le(&header[4]) != content_size)
+        return -1;
+
+    uint8_t* table = malloc((size_t)frame_count * entry_size);
+    zf->frames = malloc(frame_count * sizeof(zstd_frame_t));
+    if (!table || !zf->frames) {
+        free(table);
+        return -1;
+    }
+    if (ziprand_archive_read(zf->archive, zf->entry->data_offset + table_off + 8, table,
+                             (size_t)frame_count * entry_size) !=
+        (int64_t)((size_t)frame_count * entry_size)) {
+        free(table);
+        return -1;
+    }
+
+    uint64_t c_off = 0, d_off = 0;
+    for (uint32_t i = 0; i < frame_count; i++) {
+        const uint8_t* rec = table + (size_t)i * entry_size;
+        zf->frames[i].c_off = c_off;
+        zf->frames[i].d_off = d_off;
+        zf->frames[i].c_size = read_u32_le(&rec[0]);
+        zf->frames[i].d_size = read_u32_le(&rec[4]);
+        c_off += zf->frames[i].c_size;
+        d_off += zf->frames[i].d_size;
+    }
+    free(table);
+
+    /* the frames must tile the payload exactly */
+    if (c_off != table_off || d_off != zf->entry->uncompressed_size)
+        return -1;
+
+    zf->frame_count = frame_count;
+    return 0;
+}
+
+ziprand_zstd_t* ziprand_zstd_new(ziprand_archive_t* archive, const ziprand_entry_t* entry)
+{
+    ziprand_zstd_t* zf = calloc(1, sizeof(ziprand_zstd_t));
+    if (!zf)
+        return NULL;
+    zf->archive = archive;
+    zf->entry = entry;
+    zf->cache_frame = SIZE_MAX;
+
+    zf->dctx = ZSTD_createDCtx();
+    if (!zf->dctx || zstd_load_table(zf) != 0) {
+        ziprand_zstd_free(zf);
+        return NULL;
+    }
+    return zf;
+}
+
+void ziprand_zstd_free(ziprand_zstd_t* zf)
+{
+    if (!zf)
+        return;
+    ZSTD_freeDCtx(zf->dctx);
+    free(zf->frames);
+    free(zf->cache);
+    free(zf);
+}
+
+/* index of the frame containing uncompressed offset target */
+static size_t zstd_find_frame(const ziprand_zstd_t* zf, uint64_t target)
+{
+    size_t lo = 0, hi = zf->frame_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (zf->frames[mid].d_off <= target)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* decompress one whole frame into the cache */
+static int zstd_load_frame(ziprand_zstd_t* zf, size_t index)
+{
+    if (zf->cache_frame == index)
+        return 0;
+
+    const zstd_frame_t* frame = &zf->frames[index];
+    if (frame->d_size > zf->cache_cap) {
+        uint8_t* cache = realloc(zf->cache, frame->d_size);
+        if (!cache)
+            return -1;
+        zf->cache = cache;
+        zf->cache_cap = frame->d_size;
+    }
+
+    uint8_t* src = malloc(frame->c_size);
+    if (!src)
+        return -1;
+    if (ziprand_archive_read(zf->archive, zf->entry->data_offset + frame->c_off, src,
+                             frame->c_size) != (int64_t)frame->c_size) {
+        free(src);
+        return -1;
+    }
+
+    /* the cache is about to be overwritten: stop naming the old frame
+     * now, so a failed decompress cannot leave the fast path serving
+     * its garbage on a later read */
+    zf->cache_frame = SIZE_MAX;
+    size_t produced =
+        ZSTD_decompressDCtx(zf->dctx, zf->cache, zf->cache_cap, src, frame->c_size);
+    free(src);
+    if (ZSTD_isError(produced) || produced != frame->d_size)
+        return -1;
+
+    zf->cache_frame = index;
+    return 0;
+}
+
+int64_t ziprand_zstd_read_at(ziprand_zstd_t* zf, uint64_t offset, void* buffer, size_t size)
+{
+    if (!zf)
+        return -1;
+
+    uint8_t* out = buffer;
+    size_t copied = 0;
+    size_t index = zstd_find_frame(zf, offset);
+
+    while (copied < size && index < zf->frame_count) {
+        const zstd_frame_t* frame = &zf->frames[index];
+        if (zstd_load_frame(zf, index) != 0)
+            return -1;
+
+        size_t at = (size_t)(offset + copied - frame->d_off);
+        size_t avail = frame->d_size - at;
+        size_t chunk = size - copied < avail ? size - copied : avail;
+        memcpy(out + copied, zf->cache + at, chunk);
+        copied += chunk;
+        index++;
+    }
+
+    return (int64_t)copied;
+}